@@ -0,0 +1,9 @@
+//---------------------------------------------------------------------------------------------
+// contact sensor: the commands the contact input sends come from the press-command and
+// release-command properties of the board's gpio-keys children. button 1 is the identify
+// button.
+//
+
+#include "sleepy_input.h"
+
+SLEEPY_INPUT_DISPATCH_TABLE_DEFINE ();
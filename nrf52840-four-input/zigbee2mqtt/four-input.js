@@ -12,15 +12,84 @@ const globalStore = require('zigbee-herdsman-converters/lib/store');
 const e = exposes.presets;
 const ea = exposes.access;
 
+// gestures other than a single press arrive as manufacturer specific command
+// 0x20 + 8 * input + gesture
+const GESTURE_CMD_BASE = 0x20;
+const gestureNames = ['single', 'double', 'triple', 'long', 'hold', 'long_release'];
+const onOffNames = ['off', 'on', 'toggle'];
+
+// manufacturer specific event command: on/off command id, input, u16 boot number, u32
+// sequence number counting from 0 at boot and u32 age of the event in ms (0xffffffff when
+// unknown)
+const FRAME_MANUF_SPECIFIC = 0x04;
+const EVENT_CMD = 0xe0;
+const EVENT_AGE_UNKNOWN = 0xffffffff;
+// sequence numbers of the current boot remembered to drop retries of published events
+const EVENT_SEEN_MAX = 32;
+
+function commandAction(cmd) {
+	if ((cmd >= GESTURE_CMD_BASE) && (((cmd - GESTURE_CMD_BASE) & 7) < gestureNames.length)) {
+		const input = (cmd - GESTURE_CMD_BASE) >> 3;
+		return `button_${input}_${gestureNames[(cmd - GESTURE_CMD_BASE) & 7]}`;
+	}
+	return `cmd_${cmd}`;
+}
+
+// action of an event command, which also stands for the plain on/off commands
+function eventAction(cmd) {
+	return (cmd < onOffNames.length) ? onOffNames[cmd] : commandAction(cmd);
+}
+
+function eventPayload(msg, data) {
+	const cmd = data[0];
+	const boot = data.readUInt16LE(2);
+	const seq = data.readUInt32LE(4);
+	const age = data.readUInt32LE(8);
+	let state = globalStore.getValue(msg.device, 'event_state');
+
+	// a new boot numbers its events from 0 again
+	if ((state === undefined) || (state.boot !== boot)) {
+		state = { boot: boot, last: -1, seen: [] };
+		globalStore.putValue(msg.device, 'event_state', state);
+	}
+
+	// a retry of an event already published, its aps ack lost on the way back
+	if (state.seen.includes(seq))
+		return;
+	state.seen.push(seq);
+	if (state.seen.length > EVENT_SEEN_MAX)
+		state.seen.shift();
+
+	const result = { action: eventAction(cmd), event_boot: boot, event_seq: seq };
+	if (seq > state.last) {
+		result.event_missed = seq - state.last - 1;
+		state.last = seq;
+	} else {
+		result.event_late = true;
+	}
+	if (age !== EVENT_AGE_UNKNOWN) {
+		result.event_age_ms = age;
+		result.event_time = new Date(Date.now() - age).toISOString();
+	}
+	return result;
+}
+
 const fromZigbee_CustomActions = {
     cluster: 'genOnOff',
     type: 'raw',
     convert: (model, msg, publish, options, meta) => {
-		if ((0, utils.hasAlreadyProcessedMessage)(msg, model, msg.data[1]))
+		// frame control, [manufacturer code,] sequence number and command id
+		const hdr = (msg.data[0] & FRAME_MANUF_SPECIFIC) ? 5 : 3;
+		const cmd = msg.data[hdr - 1];
+
+		if ((hdr === 5) && (cmd === EVENT_CMD))
+			return eventPayload(msg, msg.data.subarray(hdr));
+
+		if ((0, utils.hasAlreadyProcessedMessage)(msg, model, msg.data[hdr - 2]))
 			return;
 
 		// msg.endpoint.defaultResponse(0xfd, 0, 6, msg.data[1]).catch((error) => { });
-        return { action: `cmd_${msg.data[2]}`};
+        return { action: commandAction(cmd)};
     },
 };
 
@@ -0,0 +1,9 @@
+//---------------------------------------------------------------------------------------------
+// four-input device: the commands buttons 0 to 3 send come from the press-command and
+// release-command properties of the board's gpio-keys children. button 4 is the identify
+// button.
+//
+
+#include "sleepy_input.h"
+
+SLEEPY_INPUT_DISPATCH_TABLE_DEFINE ();
@@ -0,0 +1,87 @@
+//---------------------------------------------------------------------------------------------
+// fake nrfx saadc driver
+//
+// Conversions return the virtual battery voltage of the fake stack, on VDD or divided by 5 on
+// VDDHDIV5, saturating at the full scale like the real converter.
+//
+
+#ifndef NRFX_SAADC_H__
+#define NRFX_SAADC_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int nrfx_err_t;
+
+#define NRFX_SUCCESS              0x0BAD0000
+#define NRFX_ERROR_INVALID_STATE  0x0BAD0008
+#define NRFX_ERROR_BUSY           0x0BAD000B
+
+typedef int16_t nrf_saadc_value_t;
+
+typedef enum { NRF_SAADC_RESISTOR_DISABLED = 0 } nrf_saadc_resistor_t;
+typedef enum { NRF_SAADC_GAIN1_6 = 0 } nrf_saadc_gain_t;
+typedef enum { NRF_SAADC_REFERENCE_INTERNAL = 0 } nrf_saadc_reference_t;
+typedef enum { NRF_SAADC_MODE_SINGLE_ENDED = 0 } nrf_saadc_mode_t;
+typedef enum { NRF_SAADC_BURST_DISABLED = 0, NRF_SAADC_BURST_ENABLED = 1 } nrf_saadc_burst_t;
+typedef enum {
+	NRF_SAADC_INPUT_DISABLED = 0,
+	NRF_SAADC_INPUT_VDD = 9,
+	NRF_SAADC_INPUT_VDDHDIV5 = 0x0D,
+} nrf_saadc_input_t;
+typedef enum { NRF_SAADC_RESOLUTION_14BIT = 3 } nrf_saadc_resolution_t;
+typedef enum { NRF_SAADC_OVERSAMPLE_8X = 3 } nrf_saadc_oversample_t;
+
+#define NRFX_SAADC_DEFAULT_ACQTIME 2
+
+typedef struct {
+	nrf_saadc_resistor_t resistor_p;
+	nrf_saadc_resistor_t resistor_n;
+	nrf_saadc_gain_t gain;
+	nrf_saadc_reference_t reference;
+	uint8_t acq_time;
+	nrf_saadc_mode_t mode;
+	nrf_saadc_burst_t burst;
+} nrf_saadc_channel_config_t;
+
+typedef struct {
+	nrf_saadc_channel_config_t channel_config;
+	nrf_saadc_input_t pin_p;
+	nrf_saadc_input_t pin_n;
+	uint8_t channel_index;
+} nrfx_saadc_channel_t;
+
+typedef enum {
+	NRFX_SAADC_EVT_DONE,
+	NRFX_SAADC_EVT_LIMIT,
+	NRFX_SAADC_EVT_CALIBRATEDONE,
+	NRFX_SAADC_EVT_BUF_REQ,
+	NRFX_SAADC_EVT_READY,
+	NRFX_SAADC_EVT_FINISHED,
+} nrfx_saadc_evt_type_t;
+
+typedef struct {
+	nrf_saadc_value_t *p_buffer;
+	uint16_t size;
+} nrfx_saadc_done_evt_t;
+
+typedef struct {
+	nrfx_saadc_evt_type_t type;
+	union {
+		nrfx_saadc_done_evt_t done;
+	} data;
+} nrfx_saadc_evt_t;
+
+typedef void (*nrfx_saadc_event_handler_t)(nrfx_saadc_evt_t const *p_event);
+
+nrfx_err_t nrfx_saadc_init (uint8_t interrupt_priority);
+void nrfx_saadc_uninit (void);
+nrfx_err_t nrfx_saadc_channel_config (nrfx_saadc_channel_t const *p_channel);
+nrfx_err_t nrfx_saadc_simple_mode_set (uint32_t channel_mask, nrf_saadc_resolution_t resolution,
+                                       nrf_saadc_oversample_t oversampling,
+                                       nrfx_saadc_event_handler_t event_handler);
+nrfx_err_t nrfx_saadc_buffer_set (nrf_saadc_value_t *p_buffer, uint16_t size);
+nrfx_err_t nrfx_saadc_mode_trigger (void);
+void nrfx_saadc_irq_handler (void);
+
+#endif // NRFX_SAADC_H__
@@ -0,0 +1,16 @@
+//---------------------------------------------------------------------------------------------
+// fake ram power down library
+//
+
+#ifndef RAM_PWRDN_H_
+#define RAM_PWRDN_H_
+
+static inline void power_down_unused_ram (void)
+{
+}
+
+static inline void power_up_unused_ram (void)
+{
+}
+
+#endif // RAM_PWRDN_H_
@@ -0,0 +1,14 @@
+//---------------------------------------------------------------------------------------------
+// fake zboss memory configuration
+//
+// The fake stack sizes its pools from Kconfig; these defaults only exist so the application's
+// zb_mem_config_custom.h can #undef and redefine them as it does against the real stack.
+//
+
+#ifndef ZB_MEM_CONFIG_COMMON_H
+#define ZB_MEM_CONFIG_COMMON_H 1
+
+#define ZB_CONFIG_SCHEDULER_Q_SIZE    16
+#define ZB_CONFIG_APS_DUPS_TABLE_SIZE 32
+
+#endif // ZB_MEM_CONFIG_COMMON_H
@@ -0,0 +1,8 @@
+//---------------------------------------------------------------------------------------------
+// fake zboss memory context definitions
+//
+
+#ifndef ZB_MEM_CONFIG_CONTEXT_H
+#define ZB_MEM_CONFIG_CONTEXT_H 1
+
+#endif // ZB_MEM_CONFIG_CONTEXT_H
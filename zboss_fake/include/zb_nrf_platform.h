@@ -0,0 +1,18 @@
+//---------------------------------------------------------------------------------------------
+// fake nrf platform glue
+//
+
+#ifndef ZB_NRF_PLATFORM_H__
+#define ZB_NRF_PLATFORM_H__
+
+#include "zboss_api.h"
+
+// start the fake zboss thread
+void zigbee_enable (void);
+
+// thread and isr safe scheduling, same as the nrf connect sdk glue
+zb_ret_t zigbee_schedule_callback (zb_callback_t func, zb_uint8_t param);
+zb_ret_t zigbee_schedule_callback2 (zb_callback2_t func, zb_uint8_t param, zb_uint16_t user_param);
+zb_ret_t zigbee_schedule_alarm (zb_callback_t func, zb_uint8_t param, zb_time_t run_after);
+
+#endif // ZB_NRF_PLATFORM_H__
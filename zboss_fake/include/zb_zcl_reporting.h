@@ -0,0 +1,65 @@
+//---------------------------------------------------------------------------------------------
+// fake zcl attribute reporting
+//
+
+#ifndef ZB_ZCL_REPORTING_H
+#define ZB_ZCL_REPORTING_H 1
+
+#include "zboss_api.h"
+
+#define ZB_ZCL_CONFIGURE_REPORTING_SEND_REPORT 0x00
+#define ZB_ZCL_CONFIGURE_REPORTING_RECV_REPORT 0x01
+
+// reporting_info flags
+#define ZB_ZCL_REPORTING_SLOT_BUSY 0x01
+#define ZB_ZCL_REPORT_ATTR         0x02
+#define ZB_ZCL_REPORT_IS_ALLOWED   0x04
+
+typedef union zb_zcl_attr_var_u {
+	zb_uint8_t u8;
+	zb_int8_t s8;
+	zb_uint16_t u16;
+	zb_int16_t s16;
+	zb_uint32_t u32;
+	zb_int32_t s32;
+} zb_zcl_attr_var_t;
+
+typedef struct zb_zcl_reporting_info_s {
+	zb_uint8_t direction;
+	zb_uint8_t ep;
+	zb_uint16_t cluster_id;
+	zb_uint8_t cluster_role;
+	zb_uint16_t attr_id;
+	zb_uint8_t flags;
+	zb_time_t run_time;
+	union {
+		struct {
+			zb_uint16_t min_interval;
+			zb_uint16_t max_interval;
+			zb_zcl_attr_var_t delta;
+			zb_zcl_attr_var_t reported_value;
+			zb_uint16_t def_min_interval;
+			zb_uint16_t def_max_interval;
+		} send_info;
+		struct {
+			zb_uint16_t timeout;
+		} recv_info;
+	} u;
+	struct {
+		zb_uint16_t short_addr;
+		zb_uint8_t endpoint;
+		zb_uint16_t profile_id;
+	} dst;
+	zb_uint16_t manuf_code;
+} zb_zcl_reporting_info_t;
+
+zb_ret_t zb_zcl_put_reporting_info (zb_zcl_reporting_info_t *rep_info_ptr, zb_bool_t override);
+zb_ret_t zb_zcl_start_attr_reporting (zb_uint8_t ep, zb_uint16_t cluster_id, zb_uint8_t cluster_role,
+                                      zb_uint16_t attr_id);
+zb_ret_t zb_zcl_stop_attr_reporting (zb_uint8_t ep, zb_uint16_t cluster_id, zb_uint8_t cluster_role,
+                                     zb_uint16_t attr_id);
+zb_zcl_reporting_info_t *zb_zcl_get_reporting_info (zb_uint8_t slot_number);
+zb_zcl_reporting_info_t *zb_zcl_find_reporting_info (zb_uint8_t ep, zb_uint16_t cluster_id,
+                                                     zb_uint8_t cluster_role, zb_uint16_t attr_id);
+
+#endif // ZB_ZCL_REPORTING_H
@@ -0,0 +1,703 @@
+//---------------------------------------------------------------------------------------------
+// fake zboss api
+//
+// Just enough of the ZBOSS API for the applications to build and run on native_sim. Names,
+// types and macro signatures follow ZBOSS so main.c compiles unchanged; the implementation
+// in zboss_fake.c records frames instead of transmitting them.
+//
+
+#ifndef ZBOSS_API_H
+#define ZBOSS_API_H 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+//---------------------------------------------------------------------------------------------
+// basic types
+//
+
+#define ZB_ED_ROLE
+
+typedef uint8_t  zb_uint8_t;
+typedef int8_t   zb_int8_t;
+typedef uint16_t zb_uint16_t;
+typedef int16_t  zb_int16_t;
+typedef uint32_t zb_uint32_t;
+typedef int32_t  zb_int32_t;
+typedef uint8_t  zb_bool_t;
+typedef uint32_t zb_time_t;
+typedef int32_t  zb_ret_t;
+typedef uint8_t  zb_bitfield_t;
+typedef uint8_t  zb_bufid_t;
+typedef uint64_t zb_uint64_t;
+typedef unsigned int zb_uint_t;
+typedef uint8_t  zb_ieee_addr_t[8];
+
+#define ZB_TRUE  1
+#define ZB_FALSE 0
+
+#define ZB_PACKED_PRE
+#define ZB_PACKED_STRUCT __attribute__((packed))
+
+#define ZVUNUSED(v) ((void)(v))
+
+#define ZB_BUF_INVALID 0
+
+#define RET_OK             0
+#define RET_ERROR          (-1)
+#define RET_BLOCKED        (-2)
+#define RET_NO_MEMORY      (-3)
+#define RET_INVALID_PARAMETER_1 (-4)
+#define RET_INVALID_STATE  (-5)
+#define RET_OVERFLOW       (-6)
+#define RET_NOT_FOUND      (-7)
+#define RET_BUSY           (-8)
+
+typedef void (*zb_callback_t)(zb_uint8_t param);
+typedef void (*zb_callback2_t)(zb_uint8_t param, zb_uint16_t user_param);
+
+
+//---------------------------------------------------------------------------------------------
+// time and scheduler
+//
+
+#define ZB_BEACON_INTERVAL_USEC 15360
+
+#define ZB_MILLISECONDS_TO_BEACON_INTERVAL(ms) \
+	((zb_time_t)(((zb_uint32_t)(ms) * 1000U + ZB_BEACON_INTERVAL_USEC - 1) / ZB_BEACON_INTERVAL_USEC))
+#define ZB_TIME_BEACON_INTERVAL_TO_MSEC(bi) \
+	((zb_uint32_t)(((zb_uint64_t)(bi) * ZB_BEACON_INTERVAL_USEC) / 1000U))
+#define ZB_TIME_ONE_SECOND ZB_MILLISECONDS_TO_BEACON_INTERVAL(1000)
+
+#define ZB_ALARM_ANY_PARAM ((zb_uint8_t)(-1))
+
+zb_ret_t zb_fake_schedule_callback (zb_callback_t func, zb_uint8_t param);
+zb_ret_t zb_fake_schedule_callback2 (zb_callback2_t func, zb_uint8_t param, zb_uint16_t user_param);
+zb_ret_t zb_fake_schedule_alarm (zb_callback_t func, zb_uint8_t param, zb_time_t timeout_bi);
+zb_ret_t zb_fake_schedule_alarm_cancel (zb_callback_t func, zb_uint8_t param);
+
+#define ZB_SCHEDULE_APP_CALLBACK(func, param)          zb_fake_schedule_callback ((func), (param))
+#define ZB_SCHEDULE_APP_CALLBACK2(func, param, uparam) zb_fake_schedule_callback2 ((func), (param), (uparam))
+#define ZB_SCHEDULE_APP_ALARM(func, param, timeout_bi) zb_fake_schedule_alarm ((func), (param), (timeout_bi))
+#define ZB_SCHEDULE_APP_ALARM_CANCEL(func, param)      zb_fake_schedule_alarm_cancel ((func), (param))
+
+zb_time_t zb_fake_time_get (void);
+#define ZB_TIMER_GET() zb_fake_time_get ()
+
+
+//---------------------------------------------------------------------------------------------
+// buffers
+//
+
+zb_ret_t zb_buf_get_out_delayed_ext (zb_callback2_t func, zb_uint16_t param, zb_uint16_t max_size);
+zb_ret_t zb_buf_get_out_delayed (zb_callback_t func);
+zb_bufid_t zb_buf_get_out (void);
+void zb_buf_free (zb_bufid_t buf);
+void *zb_buf_begin (zb_bufid_t buf);
+zb_bool_t zb_buf_memory_low (void);
+zb_bool_t zb_buf_is_oom_state (void);
+
+// parameter area of a buffer, e.g. the send status handed to a zcl command's callback
+void *zb_fake_buf_param (zb_bufid_t buf);
+#define ZB_BUF_GET_PARAM(buf, type) ((type *)zb_fake_buf_param ((buf)))
+
+
+//---------------------------------------------------------------------------------------------
+// addressing and profiles
+//
+
+#define ZB_AF_HA_PROFILE_ID                 0x0104
+
+#define ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT 0
+#define ZB_APS_ADDR_MODE_16_GROUP_ENDP_NOT_PRESENT 1
+#define ZB_APS_ADDR_MODE_16_ENDP_PRESENT    2
+#define ZB_APS_ADDR_MODE_64_ENDP_PRESENT    3
+
+
+//---------------------------------------------------------------------------------------------
+// zcl attribute types, access and descriptors
+//
+
+#define ZB_ZCL_VERSION 3
+
+#define ZB_ZCL_ATTR_TYPE_NULL          0x00
+#define ZB_ZCL_ATTR_TYPE_BOOL          0x10
+#define ZB_ZCL_ATTR_TYPE_8BITMAP       0x18
+#define ZB_ZCL_ATTR_TYPE_16BITMAP      0x19
+#define ZB_ZCL_ATTR_TYPE_32BITMAP      0x1b
+#define ZB_ZCL_ATTR_TYPE_U8            0x20
+#define ZB_ZCL_ATTR_TYPE_U16           0x21
+#define ZB_ZCL_ATTR_TYPE_U32           0x23
+#define ZB_ZCL_ATTR_TYPE_S8            0x28
+#define ZB_ZCL_ATTR_TYPE_S16           0x29
+#define ZB_ZCL_ATTR_TYPE_8BIT_ENUM     0x30
+#define ZB_ZCL_ATTR_TYPE_OCTET_STRING  0x41
+#define ZB_ZCL_ATTR_TYPE_CHAR_STRING   0x42
+
+#define ZB_ZCL_ATTR_ACCESS_READ_ONLY   0x01
+#define ZB_ZCL_ATTR_ACCESS_WRITE_ONLY  0x02
+#define ZB_ZCL_ATTR_ACCESS_READ_WRITE  0x03
+#define ZB_ZCL_ATTR_ACCESS_REPORTING   0x04
+#define ZB_ZCL_ATTR_MANUF_SPEC         0x20
+
+#define ZB_ZCL_NON_MANUFACTURER_SPECIFIC 0xFFFF
+#define ZB_ZCL_MANUF_CODE_INVALID        0x0000
+
+#define ZB_ZCL_NULL_ID                          0xFFFF
+#define ZB_ZCL_ATTR_GLOBAL_CLUSTER_REVISION_ID  0xFFFD
+
+typedef struct zb_zcl_attr_s {
+	zb_uint16_t id;
+	zb_uint8_t type;
+	zb_uint8_t access;
+	zb_uint16_t manuf_code;
+	void *data_p;
+} zb_zcl_attr_t;
+
+#define ZB_ZCL_ARRAY_SIZE(ar, type) (sizeof(ar) / sizeof(type))
+
+#define ZB_ZCL_START_DECLARE_ATTRIB_LIST(attrs_desc_list_name) \
+	zb_zcl_attr_t attrs_desc_list_name[] = {
+
+#define ZB_ZCL_START_DECLARE_ATTRIB_LIST_CLUSTER_REVISION(attrs_desc_list_name, cluster_revision_name) \
+	zb_uint16_t cluster_revision_##attrs_desc_list_name = cluster_revision_name##_CLUSTER_REVISION_DEFAULT; \
+	ZB_ZCL_START_DECLARE_ATTRIB_LIST(attrs_desc_list_name) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_GLOBAL_CLUSTER_REVISION_ID, &cluster_revision_##attrs_desc_list_name, \
+		ZB_ZCL_ATTR_TYPE_U16, ZB_ZCL_ATTR_ACCESS_READ_ONLY)
+
+#define ZB_ZCL_SET_ATTR_DESC(attr_id, data_ptr) ZB_SET_ATTR_DESCR_WITH_##attr_id(data_ptr),
+
+#define ZB_ZCL_SET_ATTR_DESC_M(attr_id, data_ptr, attr_type, attr_access) \
+	{ (attr_id), (attr_type), (attr_access), ZB_ZCL_NON_MANUFACTURER_SPECIFIC, (void *)(data_ptr) },
+
+#define ZB_ZCL_FINISH_DECLARE_ATTRIB_LIST \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_NULL_ID, NULL, ZB_ZCL_ATTR_TYPE_NULL, ZB_ZCL_ATTR_ACCESS_READ_ONLY) }
+
+#define ZB_ZCL_STRING_CONST_SIZE(str) (zb_uint8_t)(sizeof(str) - 1)
+
+#define ZB_ZCL_SET_STRING_VAL(str, val, len) \
+	do { ((zb_uint8_t *)(str))[0] = (len); memcpy ((zb_uint8_t *)(str) + 1, (val), (len)); } while (0)
+
+#define ZB_ZCL_STRING_TO_C_STRING(str) ((char *)(str) + 1)
+
+
+//---------------------------------------------------------------------------------------------
+// zcl clusters, endpoints and device context
+//
+
+#define ZB_ZCL_CLUSTER_ID_BASIC         0x0000
+#define ZB_ZCL_CLUSTER_ID_POWER_CONFIG  0x0001
+#define ZB_ZCL_CLUSTER_ID_IDENTIFY      0x0003
+#define ZB_ZCL_CLUSTER_ID_ON_OFF        0x0006
+
+#define ZB_ZCL_CLUSTER_SERVER_ROLE 0x01
+#define ZB_ZCL_CLUSTER_CLIENT_ROLE 0x02
+
+typedef void (*zb_zcl_cluster_init_t)(void);
+
+typedef struct zb_zcl_cluster_desc_s {
+	zb_uint16_t cluster_id;
+	zb_uint16_t attr_count;
+	zb_zcl_attr_t *attr_desc_list;
+	zb_uint8_t role_mask;
+	zb_uint16_t manuf_code;
+	zb_zcl_cluster_init_t cluster_init;
+} zb_zcl_cluster_desc_t;
+
+// the real stack calls <cluster_id>_SERVER_ROLE_INIT / _CLIENT_ROLE_INIT; the fake has
+// no per-cluster handlers so only the descriptor is kept
+#define ZB_ZCL_CLUSTER_DESC(cluster_id, attrs_count, attrs_desc_list, cluster_role_mask, cluster_manuf_code) \
+	{ (cluster_id), (attrs_count), (attrs_desc_list), (cluster_role_mask), (cluster_manuf_code), NULL }
+
+typedef ZB_PACKED_PRE struct zb_af_simple_desc_1_1_s {
+	zb_uint8_t endpoint;
+	zb_uint16_t app_profile_id;
+	zb_uint16_t app_device_id;
+	zb_bitfield_t app_device_version:4;
+	zb_bitfield_t reserved:4;
+	zb_uint8_t app_input_cluster_count;
+	zb_uint8_t app_output_cluster_count;
+	zb_uint16_t app_cluster_list[2];
+} ZB_PACKED_STRUCT zb_af_simple_desc_1_1_t;
+
+#define ZB_DECLARE_SIMPLE_DESC(in_clusters_count, out_clusters_count) \
+	typedef ZB_PACKED_PRE struct zb_af_simple_desc_##in_clusters_count##_##out_clusters_count##_s { \
+		zb_uint8_t endpoint; \
+		zb_uint16_t app_profile_id; \
+		zb_uint16_t app_device_id; \
+		zb_bitfield_t app_device_version:4; \
+		zb_bitfield_t reserved:4; \
+		zb_uint8_t app_input_cluster_count; \
+		zb_uint8_t app_output_cluster_count; \
+		zb_uint16_t app_cluster_list[(in_clusters_count) + (out_clusters_count)]; \
+	} ZB_PACKED_STRUCT zb_af_simple_desc_##in_clusters_count##_##out_clusters_count##_t
+
+#define ZB_AF_SIMPLE_DESC_TYPE(in_num, out_num) zb_af_simple_desc_##in_num##_##out_num##_t
+
+struct zb_zcl_reporting_info_s;
+
+typedef zb_uint8_t (*zb_device_handler_t)(zb_uint8_t param);
+
+typedef struct zb_af_endpoint_desc_s {
+	zb_uint8_t ep_id;
+	zb_uint16_t profile_id;
+	zb_device_handler_t device_handler;
+	zb_callback_t identify_handler;
+	zb_uint8_t reserved_size;
+	void *reserved_ptr;
+	zb_uint8_t cluster_count;
+	zb_zcl_cluster_desc_t *cluster_desc_list;
+	zb_af_simple_desc_1_1_t *simple_desc;
+	zb_uint8_t rep_info_count;
+	struct zb_zcl_reporting_info_s *reporting_info;
+	zb_uint8_t cvc_alarm_count;
+	void *cvc_alarm_info;
+} zb_af_endpoint_desc_t;
+
+typedef struct zb_af_device_ctx_s {
+	zb_uint8_t ep_count;
+	zb_af_endpoint_desc_t **ep_desc_list;
+} zb_af_device_ctx_t;
+
+#define ZBOSS_DEVICE_DECLARE_REPORTING_CTX(rep_ctx, rep_count) \
+	zb_zcl_reporting_info_t rep_ctx[rep_count]
+
+#define ZB_AF_DECLARE_ENDPOINT_DESC(ep_name, ep_id, profile_id, reserved_length, reserved_ptr, \
+		cluster_number, cluster_list, simple_desc, rep_count, rep_ctx, lev_ctrl_count, lev_ctrl_ctx) \
+	zb_af_endpoint_desc_t ep_name = { \
+		(ep_id), (profile_id), NULL, NULL, (reserved_length), (void *)(reserved_ptr), \
+		(cluster_number), (cluster_list), (simple_desc), (rep_count), (rep_ctx), \
+		(lev_ctrl_count), (lev_ctrl_ctx) \
+	}
+
+#define ZBOSS_DECLARE_DEVICE_CTX_1_EP(device_ctx_name, ep_name) \
+	zb_af_endpoint_desc_t *ep_list_##device_ctx_name[] = { &ep_name }; \
+	zb_af_device_ctx_t device_ctx_name = { 1, ep_list_##device_ctx_name }
+
+void zb_fake_register_device_ctx (zb_af_device_ctx_t *device_ctx);
+void zb_fake_set_identify_handler (zb_uint8_t ep, zb_callback_t handler);
+void zb_fake_set_endpoint_handler (zb_uint8_t ep, zb_device_handler_t handler);
+
+#define ZB_AF_REGISTER_DEVICE_CTX(device_ctx)           zb_fake_register_device_ctx (device_ctx)
+#define ZB_AF_SET_IDENTIFY_NOTIFICATION_HANDLER(ep, cb) zb_fake_set_identify_handler ((ep), (cb))
+#define ZB_AF_SET_ENDPOINT_HANDLER(ep, handler)         zb_fake_set_endpoint_handler ((ep), (handler))
+
+
+//---------------------------------------------------------------------------------------------
+// zcl attribute access
+//
+
+zb_zcl_attr_t *zb_zcl_get_attr_desc_a (zb_uint8_t ep, zb_uint16_t cluster_id, zb_uint8_t cluster_role,
+                                       zb_uint16_t attr_id);
+zb_uint8_t zb_zcl_set_attr_val (zb_uint8_t ep, zb_uint16_t cluster_id, zb_uint8_t cluster_role,
+                                zb_uint16_t attr_id, zb_uint8_t *value, zb_bool_t check_access);
+zb_uint8_t zb_zcl_get_attribute_size (zb_uint8_t attr_type, zb_uint8_t *attr_value);
+void zb_zcl_mark_attr_for_reporting (zb_uint8_t ep, zb_uint16_t cluster_id, zb_uint8_t cluster_role,
+                                     zb_uint16_t attr_id);
+
+#define ZB_ZCL_STATUS_SUCCESS         0x00
+#define ZB_ZCL_STATUS_FAIL            0x01
+#define ZB_ZCL_STATUS_UNSUP_ATTRIB    0x86
+
+
+//---------------------------------------------------------------------------------------------
+// basic cluster
+//
+
+#define ZB_ZCL_BASIC_POWER_SOURCE_UNKNOWN  0x00
+#define ZB_ZCL_BASIC_POWER_SOURCE_BATTERY  0x03
+#define ZB_ZCL_BASIC_ENV_UNSPECIFIED       0x00
+
+#define ZB_ZCL_ATTR_BASIC_ZCL_VERSION_ID         0x0000
+#define ZB_ZCL_ATTR_BASIC_APPLICATION_VERSION_ID 0x0001
+#define ZB_ZCL_ATTR_BASIC_STACK_VERSION_ID       0x0002
+#define ZB_ZCL_ATTR_BASIC_HW_VERSION_ID          0x0003
+#define ZB_ZCL_ATTR_BASIC_MANUFACTURER_NAME_ID   0x0004
+#define ZB_ZCL_ATTR_BASIC_MODEL_IDENTIFIER_ID    0x0005
+#define ZB_ZCL_ATTR_BASIC_DATE_CODE_ID           0x0006
+#define ZB_ZCL_ATTR_BASIC_POWER_SOURCE_ID        0x0007
+#define ZB_ZCL_ATTR_BASIC_LOCATION_DESCRIPTION_ID 0x0010
+#define ZB_ZCL_ATTR_BASIC_PHYSICAL_ENVIRONMENT_ID 0x0011
+#define ZB_ZCL_ATTR_BASIC_SW_BUILD_ID            0x4000
+
+#define ZB_ZCL_BASIC_CLUSTER_REVISION_DEFAULT        ((zb_uint16_t)0x0002u)
+#define ZB_ZCL_IDENTIFY_CLUSTER_REVISION_DEFAULT     ((zb_uint16_t)0x0001u)
+#define ZB_ZCL_ON_OFF_CLUSTER_REVISION_DEFAULT       ((zb_uint16_t)0x0002u)
+#define ZB_ZCL_POWER_CONFIG_CLUSTER_REVISION_DEFAULT ((zb_uint16_t)0x0001u)
+
+typedef struct zb_zcl_basic_attrs_ext_s {
+	zb_uint8_t zcl_version;
+	zb_uint8_t app_version;
+	zb_uint8_t stack_version;
+	zb_uint8_t hw_version;
+	char mf_name[33];
+	char model_id[33];
+	char date_code[17];
+	zb_uint8_t power_source;
+	char location_id[17];
+	zb_uint8_t ph_env;
+	char sw_ver[17];
+} zb_zcl_basic_attrs_ext_t;
+
+#define ZB_ZCL_DECLARE_BASIC_ATTRIB_LIST_EXT(attr_list, zcl_version, app_version, stack_version, \
+		hardware_version, manufacturer_name, model_id, date_code, power_source, \
+		location_id, ph_env, sw_build_id) \
+	ZB_ZCL_START_DECLARE_ATTRIB_LIST_CLUSTER_REVISION(attr_list, ZB_ZCL_BASIC) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_BASIC_ZCL_VERSION_ID, (zcl_version), ZB_ZCL_ATTR_TYPE_U8, ZB_ZCL_ATTR_ACCESS_READ_ONLY) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_BASIC_APPLICATION_VERSION_ID, (app_version), ZB_ZCL_ATTR_TYPE_U8, ZB_ZCL_ATTR_ACCESS_READ_ONLY) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_BASIC_STACK_VERSION_ID, (stack_version), ZB_ZCL_ATTR_TYPE_U8, ZB_ZCL_ATTR_ACCESS_READ_ONLY) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_BASIC_HW_VERSION_ID, (hardware_version), ZB_ZCL_ATTR_TYPE_U8, ZB_ZCL_ATTR_ACCESS_READ_ONLY) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_BASIC_MANUFACTURER_NAME_ID, (manufacturer_name), ZB_ZCL_ATTR_TYPE_CHAR_STRING, ZB_ZCL_ATTR_ACCESS_READ_ONLY) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_BASIC_MODEL_IDENTIFIER_ID, (model_id), ZB_ZCL_ATTR_TYPE_CHAR_STRING, ZB_ZCL_ATTR_ACCESS_READ_ONLY) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_BASIC_DATE_CODE_ID, (date_code), ZB_ZCL_ATTR_TYPE_CHAR_STRING, ZB_ZCL_ATTR_ACCESS_READ_ONLY) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_BASIC_POWER_SOURCE_ID, (power_source), ZB_ZCL_ATTR_TYPE_8BIT_ENUM, ZB_ZCL_ATTR_ACCESS_READ_ONLY) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_BASIC_LOCATION_DESCRIPTION_ID, (location_id), ZB_ZCL_ATTR_TYPE_CHAR_STRING, ZB_ZCL_ATTR_ACCESS_READ_WRITE) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_BASIC_PHYSICAL_ENVIRONMENT_ID, (ph_env), ZB_ZCL_ATTR_TYPE_8BIT_ENUM, ZB_ZCL_ATTR_ACCESS_READ_WRITE) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_BASIC_SW_BUILD_ID, (sw_build_id), ZB_ZCL_ATTR_TYPE_CHAR_STRING, ZB_ZCL_ATTR_ACCESS_READ_ONLY) \
+	ZB_ZCL_FINISH_DECLARE_ATTRIB_LIST
+
+
+//---------------------------------------------------------------------------------------------
+// identify cluster
+//
+
+#define ZB_ZCL_ATTR_IDENTIFY_IDENTIFY_TIME_ID       0x0000
+#define ZB_ZCL_IDENTIFY_IDENTIFY_TIME_DEFAULT_VALUE 0x0000
+
+typedef struct zb_zcl_identify_attrs_s {
+	zb_uint16_t identify_time;
+} zb_zcl_identify_attrs_t;
+
+#define ZB_ZCL_DECLARE_IDENTIFY_CLIENT_ATTRIB_LIST(attr_list) \
+	ZB_ZCL_START_DECLARE_ATTRIB_LIST_CLUSTER_REVISION(attr_list, ZB_ZCL_IDENTIFY) \
+	ZB_ZCL_FINISH_DECLARE_ATTRIB_LIST
+
+#define ZB_ZCL_DECLARE_IDENTIFY_SERVER_ATTRIB_LIST(attr_list, identify_time) \
+	ZB_ZCL_START_DECLARE_ATTRIB_LIST_CLUSTER_REVISION(attr_list, ZB_ZCL_IDENTIFY) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_IDENTIFY_IDENTIFY_TIME_ID, (identify_time), ZB_ZCL_ATTR_TYPE_U16, ZB_ZCL_ATTR_ACCESS_READ_WRITE) \
+	ZB_ZCL_FINISH_DECLARE_ATTRIB_LIST
+
+zb_ret_t zb_bdb_finding_binding_target (zb_uint8_t endpoint);
+void zb_bdb_finding_binding_target_cancel (void);
+
+
+//---------------------------------------------------------------------------------------------
+// on/off cluster
+//
+
+#define ZB_ZCL_CMD_ON_OFF_OFF_ID    0x00
+#define ZB_ZCL_CMD_ON_OFF_ON_ID     0x01
+#define ZB_ZCL_CMD_ON_OFF_TOGGLE_ID 0x02
+
+#define ZB_ZCL_ENABLE_DEFAULT_RESPONSE  0x00
+#define ZB_ZCL_DISABLE_DEFAULT_RESPONSE 0x01
+
+#define ZB_ZCL_DECLARE_ON_OFF_CLIENT_ATTRIB_LIST(attr_list) \
+	ZB_ZCL_START_DECLARE_ATTRIB_LIST_CLUSTER_REVISION(attr_list, ZB_ZCL_ON_OFF) \
+	ZB_ZCL_FINISH_DECLARE_ATTRIB_LIST
+
+// outcome of a zcl command, in the parameter area of the buffer handed to the command's
+// callback. RET_OK once the aps ack arrived.
+typedef struct zb_zcl_command_send_status_s {
+	zb_ret_t status;
+	zb_uint8_t dst_endpoint;
+	zb_uint8_t src_endpoint;
+} zb_zcl_command_send_status_t;
+
+// send a cluster specific command without payload and record it as an emitted frame
+void zb_fake_send_cmd (zb_bufid_t buf, zb_uint16_t dst_addr, zb_uint8_t dst_ep, zb_uint8_t ep,
+                       zb_uint16_t cluster_id, zb_uint8_t cmd_id, zb_callback_t cb);
+
+#define ZB_ZCL_ON_OFF_SEND_REQ(buffer, addr, dst_addr_mode, dst_ep, ep, prof_id, dis_default_resp, \
+		command_id, cb) \
+	zb_fake_send_cmd ((buffer), (addr), (dst_ep), (ep), ZB_ZCL_CLUSTER_ID_ON_OFF, (command_id), (cb))
+
+
+//---------------------------------------------------------------------------------------------
+// zcl frame construction
+//
+
+#define ZB_ZCL_FRAME_DIRECTION_TO_SRV      0x00
+#define ZB_ZCL_FRAME_DIRECTION_TO_CLI      0x01
+
+#define ZB_ZCL_NOT_MANUFACTURER_SPECIFIC   0x00
+#define ZB_ZCL_MANUFACTURER_SPECIFIC       0x01
+
+#define ZB_ZCL_CMD_READ_ATTRIB             0x00
+#define ZB_ZCL_CMD_CONFIG_REPORT           0x06
+#define ZB_ZCL_CMD_REPORT_ATTRIB           0x0a
+
+// header of a received zcl frame, in the parameter area of the buffer an endpoint handler
+// gets; the fields the application looks at. the fake receives no zcl frames, so endpoint
+// handlers are registered and never called.
+typedef struct zb_zcl_parsed_hdr_s {
+	zb_uint16_t cluster_id;
+	zb_uint16_t profile_id;
+	zb_uint8_t cmd_id;
+	zb_uint8_t cmd_direction;
+	zb_uint8_t seq_number;
+	zb_bool_t is_common_command;
+	zb_bool_t disable_default_response;
+	zb_bool_t is_manuf_specific;
+	zb_uint16_t manuf_specific;
+} zb_zcl_parsed_hdr_t;
+
+zb_uint8_t zb_fake_next_tsn (void);
+void zb_fake_buf_finish (zb_bufid_t buf, zb_uint8_t *ptr);
+zb_uint8_t *zb_zcl_put_value_to_packet (zb_uint8_t *cmd_ptr, zb_uint8_t attr_type, zb_uint8_t *attr_value);
+
+// send a zcl frame built in the buffer and record it as an emitted frame
+void zb_fake_send_frame (zb_bufid_t buf, zb_uint16_t dst_addr, zb_uint8_t dst_ep, zb_uint8_t ep,
+                         zb_uint16_t cluster_id, zb_callback_t cb);
+
+#define ZB_ZCL_GET_SEQ_NUM() zb_fake_next_tsn ()
+
+#define ZB_ZCL_START_PACKET(buf) ((zb_uint8_t *)zb_buf_begin (buf))
+#define ZB_ZCL_FINISH_PACKET(buf, ptr) zb_fake_buf_finish ((buf), (ptr));
+
+#define ZB_ZCL_CONSTRUCT_GENERAL_COMMAND_REQ_FRAME_CONTROL_A(ptr, direction, is_manuf_specific, def_resp) \
+	(*(ptr)++ = (zb_uint8_t)(((def_resp) << 4) | ((direction) << 3) | ((is_manuf_specific) << 2)))
+
+#define ZB_ZCL_CONSTRUCT_SPECIFIC_COMMAND_REQ_FRAME_CONTROL_A(ptr, direction, is_manuf_specific, def_resp) \
+	(*(ptr)++ = (zb_uint8_t)(0x01 | ((def_resp) << 4) | ((direction) << 3) | ((is_manuf_specific) << 2)))
+
+#define ZB_ZCL_CONSTRUCT_COMMAND_HEADER(ptr, tsn, cmd_id) \
+	(*(ptr)++ = (tsn), *(ptr)++ = (cmd_id))
+
+#define ZB_ZCL_CONSTRUCT_COMMAND_HEADER_EXT(ptr, tsn, is_manuf_specific, manuf_code, cmd_id) \
+	do { \
+		if (is_manuf_specific) { \
+			ZB_ZCL_PACKET_PUT_DATA16_VAL((ptr), (manuf_code)); \
+		} \
+		ZB_ZCL_CONSTRUCT_COMMAND_HEADER((ptr), (tsn), (cmd_id)); \
+	} while (0)
+
+#define ZB_ZCL_PACKET_PUT_DATA8(ptr, val) \
+	(*(ptr)++ = (zb_uint8_t)(val))
+
+#define ZB_ZCL_PACKET_PUT_DATA16_VAL(ptr, val) \
+	(*(ptr)++ = (zb_uint8_t)(val), *(ptr)++ = (zb_uint8_t)((val) >> 8))
+
+#define ZB_ZCL_PACKET_PUT_DATA32_VAL(ptr, val) \
+	(ZB_ZCL_PACKET_PUT_DATA16_VAL((ptr), (val)), ZB_ZCL_PACKET_PUT_DATA16_VAL((ptr), (val) >> 16))
+
+#define ZB_ZCL_SEND_COMMAND_SHORT(buf, addr, dst_addr_mode, dst_ep, ep, prof_id, cluster_id, cb) \
+	zb_fake_send_frame ((buf), (addr), (dst_ep), (ep), (cluster_id), (cb))
+
+// cluster specific response, server to client, no default response
+#define ZB_ZCL_CONSTRUCT_SPECIFIC_COMMAND_RES_FRAME_CONTROL(ptr) \
+	(*(ptr)++ = (zb_uint8_t)(0x01 | (ZB_ZCL_FRAME_DIRECTION_TO_CLI << 3) | (ZB_ZCL_DISABLE_DEFAULT_RESPONSE << 4)))
+
+
+//---------------------------------------------------------------------------------------------
+// alarms cluster
+//
+
+#define ZB_ZCL_CLUSTER_ID_ALARMS    0x0009
+
+#define ZB_ZCL_CMD_ALARMS_ALARM_ID  0x00
+
+#define ZB_ZCL_ALARMS_SEND_ALARM_RES(buffer, addr, dst_addr_mode, dst_ep, ep, prof_id, cb, \
+		alarm_code, cluster_id) \
+{ \
+	zb_uint8_t *ptr = ZB_ZCL_START_PACKET(buffer); \
+	ZB_ZCL_CONSTRUCT_SPECIFIC_COMMAND_RES_FRAME_CONTROL(ptr); \
+	ZB_ZCL_CONSTRUCT_COMMAND_HEADER(ptr, ZB_ZCL_GET_SEQ_NUM(), ZB_ZCL_CMD_ALARMS_ALARM_ID); \
+	ZB_ZCL_PACKET_PUT_DATA8(ptr, (alarm_code)); \
+	ZB_ZCL_PACKET_PUT_DATA16_VAL(ptr, (cluster_id)); \
+	ZB_ZCL_FINISH_PACKET((buffer), ptr) \
+	ZB_ZCL_SEND_COMMAND_SHORT((buffer), (addr), (dst_addr_mode), (dst_ep), (ep), (prof_id), \
+	                          ZB_ZCL_CLUSTER_ID_ALARMS, (cb)); \
+}
+
+
+//---------------------------------------------------------------------------------------------
+// binary input (basic) cluster
+//
+
+#define ZB_ZCL_CLUSTER_ID_BINARY_INPUT  0x000f
+
+#define ZB_ZCL_ATTR_BINARY_INPUT_OUT_OF_SERVICE_ID  0x0051
+#define ZB_ZCL_ATTR_BINARY_INPUT_PRESENT_VALUE_ID   0x0055
+#define ZB_ZCL_ATTR_BINARY_INPUT_STATUS_FLAG_ID     0x006f
+
+#define ZB_ZCL_BINARY_INPUT_STATUS_FLAG_NORMAL      0x00
+
+#define ZB_ZCL_BINARY_INPUT_CLUSTER_REVISION_DEFAULT ((zb_uint16_t)0x0001u)
+
+#define ZB_ZCL_DECLARE_BINARY_INPUT_ATTRIB_LIST(attr_list, out_of_service, present_value, status_flag) \
+	ZB_ZCL_START_DECLARE_ATTRIB_LIST_CLUSTER_REVISION(attr_list, ZB_ZCL_BINARY_INPUT) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_BINARY_INPUT_OUT_OF_SERVICE_ID, (out_of_service), ZB_ZCL_ATTR_TYPE_BOOL, ZB_ZCL_ATTR_ACCESS_READ_WRITE) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_BINARY_INPUT_PRESENT_VALUE_ID, (present_value), ZB_ZCL_ATTR_TYPE_BOOL, ZB_ZCL_ATTR_ACCESS_READ_WRITE | ZB_ZCL_ATTR_ACCESS_REPORTING) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_BINARY_INPUT_STATUS_FLAG_ID, (status_flag), ZB_ZCL_ATTR_TYPE_8BITMAP, ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_ACCESS_REPORTING) \
+	ZB_ZCL_FINISH_DECLARE_ATTRIB_LIST
+
+
+//---------------------------------------------------------------------------------------------
+// diagnostics cluster, attributes declared by the application
+//
+
+#define ZB_ZCL_CLUSTER_ID_DIAGNOSTICS   0x0b05
+
+// link quality and signal strength of the last frame from a neighbor
+zb_ret_t zb_zdo_get_diag_data (zb_uint16_t short_address, zb_uint8_t *lqi, zb_int8_t *rssi);
+
+
+//---------------------------------------------------------------------------------------------
+// power configuration cluster
+//
+
+#define ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_ID               0x0020
+#define ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_REMAINING_ID  0x0021
+#define ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_SIZE_ID                  0x0031
+#define ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_QUANTITY_ID              0x0033
+#define ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_RATED_VOLTAGE_ID         0x0034
+#define ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_ALARM_MASK_ID            0x0035
+#define ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_MIN_THRESHOLD_ID 0x0036
+#define ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_THRESHOLD1_ID    0x0037
+#define ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_THRESHOLD2_ID    0x0038
+#define ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_THRESHOLD3_ID    0x0039
+#define ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_MIN_THRESHOLD_ID 0x003a
+#define ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_THRESHOLD1_ID 0x003b
+#define ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_THRESHOLD2_ID 0x003c
+#define ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_THRESHOLD3_ID 0x003d
+#define ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_ALARM_STATE_ID           0x003e
+
+#define ZB_ZCL_POWER_CONFIG_BATTERY_VOLTAGE_INVALID   0xff
+#define ZB_ZCL_POWER_CONFIG_BATTERY_REMAINING_UNKNOWN 0xff
+#define ZB_ZCL_POWER_CONFIG_BATTERY_SIZE_OTHER        0xff
+
+#define ZB_ZCL_POWER_CONFIG_REPORT_ATTR_COUNT 2
+
+#define ZB_ZCL_DECLARE_POWER_CONFIG_BATTERY_ATTRIB_LIST_EXT(attr_list, voltage, size, quantity, \
+		rated_voltage, alarm_mask, voltage_min_threshold, remaining, threshold1, threshold2, \
+		threshold3, min_threshold, percent_threshold1, percent_threshold2, percent_threshold3, \
+		alarm_state) \
+	ZB_ZCL_START_DECLARE_ATTRIB_LIST_CLUSTER_REVISION(attr_list, ZB_ZCL_POWER_CONFIG) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_ID, (voltage), ZB_ZCL_ATTR_TYPE_U8, ZB_ZCL_ATTR_ACCESS_READ_ONLY) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_SIZE_ID, (size), ZB_ZCL_ATTR_TYPE_8BIT_ENUM, ZB_ZCL_ATTR_ACCESS_READ_WRITE) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_QUANTITY_ID, (quantity), ZB_ZCL_ATTR_TYPE_U8, ZB_ZCL_ATTR_ACCESS_READ_WRITE) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_RATED_VOLTAGE_ID, (rated_voltage), ZB_ZCL_ATTR_TYPE_U8, ZB_ZCL_ATTR_ACCESS_READ_WRITE) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_ALARM_MASK_ID, (alarm_mask), ZB_ZCL_ATTR_TYPE_8BITMAP, ZB_ZCL_ATTR_ACCESS_READ_WRITE) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_MIN_THRESHOLD_ID, (voltage_min_threshold), ZB_ZCL_ATTR_TYPE_U8, ZB_ZCL_ATTR_ACCESS_READ_WRITE) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_REMAINING_ID, (remaining), ZB_ZCL_ATTR_TYPE_U8, ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_ACCESS_REPORTING) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_THRESHOLD1_ID, (threshold1), ZB_ZCL_ATTR_TYPE_U8, ZB_ZCL_ATTR_ACCESS_READ_WRITE) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_THRESHOLD2_ID, (threshold2), ZB_ZCL_ATTR_TYPE_U8, ZB_ZCL_ATTR_ACCESS_READ_WRITE) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_THRESHOLD3_ID, (threshold3), ZB_ZCL_ATTR_TYPE_U8, ZB_ZCL_ATTR_ACCESS_READ_WRITE) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_MIN_THRESHOLD_ID, (min_threshold), ZB_ZCL_ATTR_TYPE_U8, ZB_ZCL_ATTR_ACCESS_READ_WRITE) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_THRESHOLD1_ID, (percent_threshold1), ZB_ZCL_ATTR_TYPE_U8, ZB_ZCL_ATTR_ACCESS_READ_WRITE) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_THRESHOLD2_ID, (percent_threshold2), ZB_ZCL_ATTR_TYPE_U8, ZB_ZCL_ATTR_ACCESS_READ_WRITE) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_THRESHOLD3_ID, (percent_threshold3), ZB_ZCL_ATTR_TYPE_U8, ZB_ZCL_ATTR_ACCESS_READ_WRITE) \
+	ZB_ZCL_SET_ATTR_DESC_M(ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_ALARM_STATE_ID, (alarm_state), ZB_ZCL_ATTR_TYPE_32BITMAP, ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_ACCESS_REPORTING) \
+	ZB_ZCL_FINISH_DECLARE_ATTRIB_LIST
+
+
+//---------------------------------------------------------------------------------------------
+// network state, signals and end device configuration
+//
+
+typedef zb_uint16_t zb_zdo_app_signal_type_t;
+
+#define ZB_ZDO_SIGNAL_DEFAULT_START      0
+#define ZB_ZDO_SIGNAL_SKIP_STARTUP       1
+#define ZB_ZDO_SIGNAL_DEVICE_ANNCE       2
+#define ZB_ZDO_SIGNAL_LEAVE              3
+#define ZB_ZDO_SIGNAL_ERROR              4
+#define ZB_BDB_SIGNAL_DEVICE_FIRST_START 5
+#define ZB_BDB_SIGNAL_DEVICE_REBOOT      6
+#define ZB_BDB_SIGNAL_STEERING           10
+#define ZB_BDB_SIGNAL_FINDING_AND_BINDING_TARGET_FINISHED 12
+#define ZB_NWK_SIGNAL_NO_ACTIVE_LINKS_LEFT 20
+#define ZB_COMMON_SIGNAL_CAN_SLEEP       22
+#define ZB_ZDO_SIGNAL_PRODUCTION_CONFIG_READY 23
+#define ZB_NLME_STATUS_INDICATION        25
+
+typedef struct zb_zdo_app_signal_hdr_s {
+	zb_uint32_t sig_type;
+} zb_zdo_app_signal_hdr_t;
+
+// parameters of a signal follow its header
+#define ZB_ZDO_SIGNAL_GET_PARAMS(sg_p, type) ((type *)(((zb_zdo_app_signal_hdr_t *)(sg_p)) + 1))
+
+#define ZB_NWK_COMMAND_STATUS_PARENT_LINK_FAILURE 0x09
+
+typedef struct zb_nlme_status_indication_s {
+	zb_uint8_t status;
+	zb_uint16_t network_addr;
+	zb_uint8_t unknown_command_id;
+} zb_nlme_status_indication_t;
+
+typedef struct zb_zdo_signal_nlme_status_indication_params_s {
+	zb_nlme_status_indication_t nlme_status;
+} zb_zdo_signal_nlme_status_indication_params_t;
+
+#define ZB_NWK_LEAVE_TYPE_RESET  0x00
+#define ZB_NWK_LEAVE_TYPE_REJOIN 0x01
+
+typedef struct zb_zdo_signal_leave_params_s {
+	zb_uint8_t leave_type;
+} zb_zdo_signal_leave_params_t;
+
+zb_zdo_app_signal_type_t zb_get_app_signal (zb_bufid_t buf, zb_zdo_app_signal_hdr_t **sg_p);
+zb_ret_t zb_fake_get_app_signal_status (zb_bufid_t buf);
+#define ZB_GET_APP_SIGNAL_STATUS(buf) zb_fake_get_app_signal_status (buf)
+
+zb_bool_t zb_fake_joined (void);
+#define ZB_JOINED() zb_fake_joined ()
+
+typedef enum {
+	ED_AGING_TIMEOUT_10SEC = 0,
+	ED_AGING_TIMEOUT_2MIN,
+	ED_AGING_TIMEOUT_4MIN,
+	ED_AGING_TIMEOUT_8MIN,
+	ED_AGING_TIMEOUT_16MIN,
+	ED_AGING_TIMEOUT_32MIN,
+	ED_AGING_TIMEOUT_64MIN,
+} zb_aging_timeout_t;
+
+void zb_set_ed_timeout (zb_uint_t timeout);
+void zb_set_keepalive_timeout (zb_uint_t timeout);
+void zb_zdo_pim_set_long_poll_interval (zb_time_t ms);
+void zb_set_rx_on_when_idle (zb_bool_t rx_on);
+
+typedef zb_uint8_t zb_ext_pan_id_t[8];
+
+#define ZB_TRANSCEIVER_ALL_CHANNELS_MASK 0x07FFF800
+
+void zb_set_bdb_primary_channel_set (zb_uint32_t channel_mask);
+void zb_set_bdb_secondary_channel_set (zb_uint32_t channel_mask);
+zb_uint8_t zb_get_current_channel (void);
+zb_uint16_t zb_get_pan_id (void);
+void zb_get_extended_pan_id (zb_ext_pan_id_t ext_pan_id);
+zb_uint16_t zb_nwk_get_parent (void);
+
+#define ZB_CHANNEL_PAGES_NUM 1
+
+typedef zb_uint32_t zb_channel_list_t[ZB_CHANNEL_PAGES_NUM];
+
+void zb_channel_list_init (zb_channel_list_t channel_list);
+zb_ret_t zb_channel_page_list_set_2_4GHz_mask (zb_channel_list_t channel_list, zb_uint32_t mask);
+
+// rejoin the network with the extended pan id on the listed channels; buf is consumed. the
+// device is joined again once ZB_JOINED () is.
+void zdo_initiate_rejoin (zb_bufid_t buf, zb_uint8_t *ext_pan_id, zb_channel_list_t channels_list,
+                          zb_bool_t secure_rejoin);
+
+// the stack's own rejoin over every channel of its mask, retried with back off
+zb_bool_t zb_zdo_rejoin_backoff_start (zb_bool_t insecure_rejoin);
+
+// application signal handler, implemented by the application
+void zboss_signal_handler (zb_bufid_t bufid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ZBOSS_API_H
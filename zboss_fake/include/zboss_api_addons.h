@@ -0,0 +1,10 @@
+//---------------------------------------------------------------------------------------------
+// fake zboss api addons
+//
+
+#ifndef ZBOSS_API_ADDONS_H
+#define ZBOSS_API_ADDONS_H 1
+
+#include "zboss_api.h"
+
+#endif // ZBOSS_API_ADDONS_H
@@ -0,0 +1,57 @@
+//---------------------------------------------------------------------------------------------
+// fake zboss stack inspection api
+//
+
+#ifndef ZBOSS_FAKE_H
+#define ZBOSS_FAKE_H 1
+
+#include <zboss_api.h>
+
+// kinds of frames the fake records
+enum zb_fake_frame_kind {
+	ZB_FAKE_FRAME_ZCL_CMD,      // cluster specific command, e.g. on/off
+	ZB_FAKE_FRAME_REPORT,       // report attributes
+	ZB_FAKE_FRAME_POLL,         // mac data request from the sleepy end device
+	ZB_FAKE_FRAME_KIND_COUNT,
+};
+
+// one recorded frame
+struct zb_fake_frame {
+	uint32_t time_ms;           // virtual time the frame left the fake radio
+	uint8_t kind;               // enum zb_fake_frame_kind
+	uint8_t src_ep;
+	uint8_t dst_ep;
+	uint8_t cmd_id;             // zcl command id for ZB_FAKE_FRAME_ZCL_CMD
+	uint16_t dst_addr;
+	uint16_t cluster_id;
+	uint16_t attr_id;           // first attribute for ZB_FAKE_FRAME_REPORT
+	uint8_t attr_count;         // attributes carried by ZB_FAKE_FRAME_REPORT
+	bool acked;                 // aps ack of a unicast frame reached the sender
+};
+
+// number of frames of one kind emitted since start
+uint32_t zb_fake_frame_count (enum zb_fake_frame_kind kind);
+
+// copy up to max of the most recent frames, oldest first; returns the number copied
+size_t zb_fake_frames_get (struct zb_fake_frame *frames, size_t max);
+
+// number of frames recorded since start, the index the next frame gets
+uint32_t zb_fake_frame_total (void);
+
+// copy the frame with the given index; false once newer frames have overwritten it
+bool zb_fake_frame_at (uint32_t index, struct zb_fake_frame *frame);
+
+// largest number of zboss buffers in use at once
+uint32_t zb_fake_buf_high_water (void);
+
+// leave and rejoin the network, delivering the matching signals to the application
+void zb_fake_leave (void);
+void zb_fake_rejoin (void);
+
+// virtual battery voltage seen by the fake saadc
+uint32_t zb_fake_battery_mv (void);
+
+// log a summary of everything recorded so far
+void zb_fake_print_summary (void);
+
+#endif // ZBOSS_FAKE_H
@@ -0,0 +1,20 @@
+//---------------------------------------------------------------------------------------------
+// fake zigbee application utilities
+//
+
+#ifndef ZIGBEE_APP_UTILS_H__
+#define ZIGBEE_APP_UTILS_H__
+
+#include <stdbool.h>
+#include <zboss_api.h>
+
+zb_ret_t zigbee_default_signal_handler (zb_bufid_t bufid);
+void zigbee_erase_persistent_storage (zb_bool_t erase);
+void zigbee_configure_sleepy_behavior (bool enable);
+void user_input_indicate (void);
+
+void register_factory_reset_button (uint32_t button);
+void check_factory_reset_button (uint32_t button_state, uint32_t has_changed);
+bool was_factory_reset_done (void);
+
+#endif // ZIGBEE_APP_UTILS_H__
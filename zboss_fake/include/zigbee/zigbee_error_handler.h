@@ -0,0 +1,20 @@
+//---------------------------------------------------------------------------------------------
+// fake zigbee error handler
+//
+
+#ifndef ZIGBEE_ERROR_HANDLER_H__
+#define ZIGBEE_ERROR_HANDLER_H__
+
+#include <zboss_api.h>
+
+void zb_fake_error_check_failed (zb_ret_t err_code, const char *file, int line);
+
+#define ZB_ERROR_CHECK(ERR_CODE) \
+	do { \
+		const zb_ret_t _err = (zb_ret_t)(ERR_CODE); \
+		if (_err != RET_OK) { \
+			zb_fake_error_check_failed (_err, __FILE__, __LINE__); \
+		} \
+	} while (0)
+
+#endif // ZIGBEE_ERROR_HANDLER_H__
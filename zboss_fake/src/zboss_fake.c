@@ -0,0 +1,1299 @@
+//---------------------------------------------------------------------------------------------
+// fake zboss stack
+//
+// Runs the application's scheduler callbacks and alarms in one thread, the same way the real
+// zboss thread does, but on kernel time. With CONFIG_NATIVE_SIM_SLOWDOWN_TO_REAL_TIME=n the
+// kernel skips idle time, so hours of sleepy end device operation replay in seconds. Every
+// frame the application would have put on air is recorded instead.
+//
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <zboss_api.h>
+#include <zb_zcl_reporting.h>
+#include <zb_nrf_platform.h>
+#include <zigbee/zigbee_app_utils.h>
+#include <zigbee/zigbee_error_handler.h>
+#include <drivers/include/nrfx_saadc.h>
+
+#include "zboss_fake.h"
+
+LOG_MODULE_REGISTER (zboss_fake, CONFIG_ZBOSS_FAKE_LOG_LEVEL);
+
+
+//---------------------------------------------------------------------------------------------
+// defines
+//
+
+#define FAKE_THREAD_STACK_SIZE     4096
+#define FAKE_THREAD_PRIORITY       K_PRIO_PREEMPT(8)
+
+// default poll interval until the application sets its own
+#define FAKE_DEFAULT_POLL_MS       5000
+
+// how long identify mode lasts when started by finding and binding
+#define FAKE_IDENTIFY_TIME_S       180
+
+// how long the factory reset button must be held
+#define FAKE_FACTORY_RESET_MS      5000
+
+// largest zcl frame the application can build in a buffer
+#define FAKE_BUF_PAYLOAD_SIZE      64
+
+// parameter area of a buffer, large enough for a zcl command's send status
+#define FAKE_BUF_PARAM_WORDS       4
+
+// network the fake always joins, with the coordinator as parent
+#define FAKE_CHANNEL               15
+#define FAKE_PAN_ID                0x1a62
+#define FAKE_PARENT                0x0000
+
+// a rejoin on one channel: a beacon request, and the rejoin request and response
+#define FAKE_REJOIN_MS             150
+
+// link to the parent as the radio would measure it
+#define FAKE_PARENT_LQI            255
+#define FAKE_PARENT_RSSI           (-45)
+
+
+//---------------------------------------------------------------------------------------------
+// typedefs
+//
+
+enum cb_type {
+	CB_WAKE,                    // no callback, only recompute the next alarm deadline
+	CB_SINGLE,
+	CB_DOUBLE,
+};
+
+struct cb_entry {
+	uint8_t type;
+	zb_uint8_t param;
+	zb_uint16_t user_param;
+	void *func;
+};
+
+struct alarm_entry {
+	bool used;
+	zb_uint8_t param;
+	zb_callback_t func;
+	int64_t deadline_ms;
+};
+
+struct buf_entry {
+	bool used;
+	zb_zdo_app_signal_type_t signal;
+	zb_ret_t status;
+	zb_uint8_t len;
+	zb_uint8_t payload[FAKE_BUF_PAYLOAD_SIZE];
+	uint32_t param[FAKE_BUF_PARAM_WORDS];
+};
+
+struct buf_waiter {
+	zb_callback2_t func;
+	zb_uint16_t param;
+};
+
+
+//---------------------------------------------------------------------------------------------
+// globals
+//
+
+K_MSGQ_DEFINE (cb_queue, sizeof(struct cb_entry), CONFIG_ZBOSS_FAKE_SCHEDULER_Q_SIZE, 4);
+K_THREAD_STACK_DEFINE (fake_stack, FAKE_THREAD_STACK_SIZE);
+static struct k_thread fake_thread;
+
+static struct k_spinlock lock;
+
+static struct alarm_entry alarms[CONFIG_ZBOSS_FAKE_ALARM_COUNT];
+
+// buffer 0 is ZB_BUF_INVALID and never handed out
+static struct buf_entry bufs[CONFIG_ZBOSS_FAKE_BUF_COUNT + 1];
+static uint32_t bufs_in_use;
+static uint32_t bufs_high_water;
+
+static struct buf_waiter waiters[CONFIG_ZBOSS_FAKE_SCHEDULER_Q_SIZE];
+static uint32_t waiters_head;
+static uint32_t waiters_tail;
+
+static struct zb_fake_frame frames[CONFIG_ZBOSS_FAKE_FRAME_LOG_SIZE];
+static uint32_t frames_total;
+static uint32_t frame_counts[ZB_FAKE_FRAME_KIND_COUNT];
+static uint32_t reported_attrs;
+static uint32_t aps_frames;
+static uint32_t aps_missed;
+static zb_uint8_t tsn;
+
+static zb_af_device_ctx_t *device_ctx;
+static zb_callback_t identify_handler;
+static zb_uint8_t identify_ep;
+
+static bool joined;
+static uint32_t long_poll_ms = FAKE_DEFAULT_POLL_MS;
+
+static uint32_t factory_reset_button;
+static bool factory_reset_done;
+
+static nrf_saadc_value_t *saadc_buffer;
+static nrf_saadc_input_t saadc_input;
+static nrfx_saadc_event_handler_t saadc_handler;
+
+
+//---------------------------------------------------------------------------------------------
+// frame recording
+//
+
+static void record_frame (const struct zb_fake_frame *frame)
+{
+	k_spinlock_key_t key = k_spin_lock (&lock);
+
+	frames[frames_total % ARRAY_SIZE(frames)] = *frame;
+	frames_total++;
+	frame_counts[frame->kind]++;
+	reported_attrs += frame->attr_count;
+
+	k_spin_unlock (&lock, key);
+}
+
+uint32_t zb_fake_frame_count (enum zb_fake_frame_kind kind)
+{
+	return (kind < ZB_FAKE_FRAME_KIND_COUNT) ? frame_counts[kind] : 0;
+}
+
+size_t zb_fake_frames_get (struct zb_fake_frame *out, size_t max)
+{
+	k_spinlock_key_t key = k_spin_lock (&lock);
+	size_t available = MIN(frames_total, ARRAY_SIZE(frames));
+	size_t count = MIN(available, max);
+	uint32_t first = frames_total - count;
+
+	for (size_t i = 0; i < count; i++) {
+		out[i] = frames[(first + i) % ARRAY_SIZE(frames)];
+	}
+
+	k_spin_unlock (&lock, key);
+	return count;
+}
+
+uint32_t zb_fake_frame_total (void)
+{
+	return frames_total;
+}
+
+bool zb_fake_frame_at (uint32_t index, struct zb_fake_frame *frame)
+{
+	k_spinlock_key_t key = k_spin_lock (&lock);
+	bool kept = (index < frames_total) && ((frames_total - index) <= ARRAY_SIZE(frames));
+
+	if (kept) {
+		*frame = frames[index % ARRAY_SIZE(frames)];
+	}
+
+	k_spin_unlock (&lock, key);
+	return kept;
+}
+
+uint32_t zb_fake_buf_high_water (void)
+{
+	return bufs_high_water;
+}
+
+void zb_fake_print_summary (void)
+{
+	uint32_t now = k_uptime_get_32 ();
+
+	LOG_INF ("===== fake zboss summary after %u.%03u s virtual time =====", now / 1000, now % 1000);
+	LOG_INF ("zcl commands: %u", frame_counts[ZB_FAKE_FRAME_ZCL_CMD]);
+	LOG_INF ("attribute reports: %u carrying %u attributes", frame_counts[ZB_FAKE_FRAME_REPORT],
+	         reported_attrs);
+	LOG_INF ("data polls: %u", frame_counts[ZB_FAKE_FRAME_POLL]);
+	LOG_INF ("aps acks missed: %u of %u frames", aps_missed, aps_frames);
+	LOG_INF ("buffer high water: %u of %u", bufs_high_water, CONFIG_ZBOSS_FAKE_BUF_COUNT);
+	LOG_INF ("battery: %u mV", zb_fake_battery_mv ());
+}
+
+
+//---------------------------------------------------------------------------------------------
+// scheduler
+//
+
+static zb_ret_t queue_cb (const struct cb_entry *entry)
+{
+	if (k_msgq_put (&cb_queue, entry, K_NO_WAIT) != 0) {
+		LOG_WRN ("scheduler queue full");
+		return RET_OVERFLOW;
+	}
+	return RET_OK;
+}
+
+zb_ret_t zb_fake_schedule_callback (zb_callback_t func, zb_uint8_t param)
+{
+	struct cb_entry entry = { .type = CB_SINGLE, .param = param, .func = func };
+
+	return queue_cb (&entry);
+}
+
+zb_ret_t zb_fake_schedule_callback2 (zb_callback2_t func, zb_uint8_t param, zb_uint16_t user_param)
+{
+	struct cb_entry entry = { .type = CB_DOUBLE, .param = param, .user_param = user_param, .func = func };
+
+	return queue_cb (&entry);
+}
+
+zb_ret_t zb_fake_schedule_alarm (zb_callback_t func, zb_uint8_t param, zb_time_t timeout_bi)
+{
+	k_spinlock_key_t key = k_spin_lock (&lock);
+	zb_ret_t ret = RET_OVERFLOW;
+
+	for (size_t i = 0; i < ARRAY_SIZE(alarms); i++) {
+		if (!alarms[i].used) {
+			alarms[i].used = true;
+			alarms[i].func = func;
+			alarms[i].param = param;
+			alarms[i].deadline_ms = k_uptime_get () + ZB_TIME_BEACON_INTERVAL_TO_MSEC(timeout_bi);
+			ret = RET_OK;
+			break;
+		}
+	}
+
+	k_spin_unlock (&lock, key);
+
+	if (ret == RET_OK) {
+		// wake the fake zboss thread so it waits for the new deadline
+		struct cb_entry entry = { .type = CB_WAKE };
+		(void)k_msgq_put (&cb_queue, &entry, K_NO_WAIT);
+	} else {
+		LOG_WRN ("alarm table full");
+	}
+
+	return ret;
+}
+
+zb_ret_t zb_fake_schedule_alarm_cancel (zb_callback_t func, zb_uint8_t param)
+{
+	k_spinlock_key_t key = k_spin_lock (&lock);
+	zb_ret_t ret = RET_NOT_FOUND;
+
+	for (size_t i = 0; i < ARRAY_SIZE(alarms); i++) {
+		if (alarms[i].used && (alarms[i].func == func) &&
+		    ((param == ZB_ALARM_ANY_PARAM) || (alarms[i].param == param))) {
+			alarms[i].used = false;
+			ret = RET_OK;
+		}
+	}
+
+	k_spin_unlock (&lock, key);
+	return ret;
+}
+
+zb_ret_t zigbee_schedule_callback (zb_callback_t func, zb_uint8_t param)
+{
+	return zb_fake_schedule_callback (func, param);
+}
+
+zb_ret_t zigbee_schedule_callback2 (zb_callback2_t func, zb_uint8_t param, zb_uint16_t user_param)
+{
+	return zb_fake_schedule_callback2 (func, param, user_param);
+}
+
+zb_ret_t zigbee_schedule_alarm (zb_callback_t func, zb_uint8_t param, zb_time_t run_after)
+{
+	return zb_fake_schedule_alarm (func, param, run_after);
+}
+
+zb_time_t zb_fake_time_get (void)
+{
+	return ZB_MILLISECONDS_TO_BEACON_INTERVAL(k_uptime_get ());
+}
+
+// run every alarm whose deadline has passed and return the time until the next one
+static int64_t run_alarms (void)
+{
+	int64_t next = INT64_MAX;
+
+	for (;;) {
+		k_spinlock_key_t key = k_spin_lock (&lock);
+		int64_t now = k_uptime_get ();
+		struct alarm_entry due = { .used = false };
+
+		next = INT64_MAX;
+		for (size_t i = 0; i < ARRAY_SIZE(alarms); i++) {
+			if (!alarms[i].used) {
+				continue;
+			}
+			if (alarms[i].deadline_ms <= now) {
+				due = alarms[i];
+				alarms[i].used = false;
+				break;
+			}
+			next = MIN(next, alarms[i].deadline_ms - now);
+		}
+
+		k_spin_unlock (&lock, key);
+
+		if (!due.used) {
+			return next;
+		}
+		due.func (due.param);
+	}
+}
+
+
+//---------------------------------------------------------------------------------------------
+// buffers
+//
+
+static zb_bufid_t buf_alloc (void)
+{
+	k_spinlock_key_t key = k_spin_lock (&lock);
+	zb_bufid_t buf = ZB_BUF_INVALID;
+
+	for (size_t i = 1; i < ARRAY_SIZE(bufs); i++) {
+		if (!bufs[i].used) {
+			memset (&bufs[i], 0, sizeof(bufs[i]));
+			bufs[i].used = true;
+			buf = (zb_bufid_t)i;
+			bufs_in_use++;
+			bufs_high_water = MAX(bufs_high_water, bufs_in_use);
+			break;
+		}
+	}
+
+	k_spin_unlock (&lock, key);
+	return buf;
+}
+
+zb_bufid_t zb_buf_get_out (void)
+{
+	return buf_alloc ();
+}
+
+// a quarter of the pool or less left
+zb_bool_t zb_buf_memory_low (void)
+{
+	return (bufs_in_use * 4) >= (CONFIG_ZBOSS_FAKE_BUF_COUNT * 3);
+}
+
+// every buffer handed out, or requests waiting for one
+zb_bool_t zb_buf_is_oom_state (void)
+{
+	return (bufs_in_use >= CONFIG_ZBOSS_FAKE_BUF_COUNT) || (waiters_head != waiters_tail);
+}
+
+zb_ret_t zb_buf_get_out_delayed_ext (zb_callback2_t func, zb_uint16_t param, zb_uint16_t max_size)
+{
+	ZVUNUSED(max_size);
+
+	zb_bufid_t buf = buf_alloc ();
+	if (buf != ZB_BUF_INVALID) {
+		zb_ret_t ret = zb_fake_schedule_callback2 (func, buf, param);
+		if (ret != RET_OK) {
+			zb_buf_free (buf);
+		}
+		return ret;
+	}
+
+	// no buffer free: wait for one, as long as there is room in the wait list
+	k_spinlock_key_t key = k_spin_lock (&lock);
+	zb_ret_t ret = RET_ERROR;
+	if ((waiters_head - waiters_tail) < ARRAY_SIZE(waiters)) {
+		waiters[waiters_head % ARRAY_SIZE(waiters)].func = func;
+		waiters[waiters_head % ARRAY_SIZE(waiters)].param = param;
+		waiters_head++;
+		ret = RET_OK;
+	}
+	k_spin_unlock (&lock, key);
+
+	return ret;
+}
+
+
+zb_ret_t zb_buf_get_out_delayed (zb_callback_t func)
+{
+	zb_bufid_t buf = buf_alloc ();
+	if (buf == ZB_BUF_INVALID) {
+		return RET_ERROR;
+	}
+	return zb_fake_schedule_callback (func, buf);
+}
+
+void *zb_buf_begin (zb_bufid_t buf)
+{
+	return bufs[buf].payload;
+}
+
+void *zb_fake_buf_param (zb_bufid_t buf)
+{
+	return bufs[buf].param;
+}
+
+void zb_fake_buf_finish (zb_bufid_t buf, zb_uint8_t *ptr)
+{
+	__ASSERT_NO_MSG((ptr >= bufs[buf].payload) && (ptr <= bufs[buf].payload + FAKE_BUF_PAYLOAD_SIZE));
+	bufs[buf].len = (zb_uint8_t)(ptr - bufs[buf].payload);
+}
+
+void zb_buf_free (zb_bufid_t buf)
+{
+	if ((buf == ZB_BUF_INVALID) || (buf >= ARRAY_SIZE(bufs))) {
+		return;
+	}
+
+	k_spinlock_key_t key = k_spin_lock (&lock);
+	bool give = false;
+	struct buf_waiter waiter;
+
+	if (!bufs[buf].used) {
+		k_spin_unlock (&lock, key);
+		LOG_ERR ("double free of buffer %u", buf);
+		return;
+	}
+
+	if (waiters_head != waiters_tail) {
+		// hand the buffer straight to the oldest waiter
+		waiter = waiters[waiters_tail % ARRAY_SIZE(waiters)];
+		waiters_tail++;
+		memset (&bufs[buf], 0, sizeof(bufs[buf]));
+		bufs[buf].used = true;
+		give = true;
+	} else {
+		bufs[buf].used = false;
+		bufs_in_use--;
+	}
+
+	k_spin_unlock (&lock, key);
+
+	if (give && (zb_fake_schedule_callback2 (waiter.func, buf, waiter.param) != RET_OK)) {
+		zb_buf_free (buf);
+	}
+}
+
+
+//---------------------------------------------------------------------------------------------
+// signals and network state
+//
+
+static void deliver_signal (zb_zdo_app_signal_type_t signal, zb_ret_t status)
+{
+	zb_bufid_t buf = buf_alloc ();
+
+	if (buf == ZB_BUF_INVALID) {
+		LOG_ERR ("no buffer for signal %u", signal);
+		return;
+	}
+
+	bufs[buf].signal = signal;
+	bufs[buf].status = status;
+	zboss_signal_handler (buf);
+}
+
+zb_zdo_app_signal_type_t zb_get_app_signal (zb_bufid_t buf, zb_zdo_app_signal_hdr_t **sg_p)
+{
+	// the header and room for the parameters of any signal after it
+	static struct {
+		zb_zdo_app_signal_hdr_t hdr;
+		union {
+			zb_zdo_signal_nlme_status_indication_params_t nlme_status;
+			zb_zdo_signal_leave_params_t leave;
+		} params;
+	} sg;
+
+	memset (&sg, 0, sizeof(sg));
+	sg.hdr.sig_type = bufs[buf].signal;
+
+	// the fake only leaves for good
+	if (bufs[buf].signal == ZB_ZDO_SIGNAL_LEAVE) {
+		sg.params.leave.leave_type = ZB_NWK_LEAVE_TYPE_RESET;
+	}
+	if (sg_p != NULL) {
+		*sg_p = &sg.hdr;
+	}
+	return bufs[buf].signal;
+}
+
+zb_ret_t zb_fake_get_app_signal_status (zb_bufid_t buf)
+{
+	return bufs[buf].status;
+}
+
+zb_bool_t zb_fake_joined (void)
+{
+	return joined ? ZB_TRUE : ZB_FALSE;
+}
+
+static void poll_alarm (zb_uint8_t param)
+{
+	ZVUNUSED(param);
+
+	if (!joined) {
+		return;
+	}
+
+	struct zb_fake_frame frame = {
+		.time_ms = k_uptime_get_32 (),
+		.kind = ZB_FAKE_FRAME_POLL,
+	};
+	record_frame (&frame);
+
+	ZB_SCHEDULE_APP_ALARM (poll_alarm, 0, ZB_MILLISECONDS_TO_BEACON_INTERVAL(long_poll_ms));
+}
+
+static void join_alarm (zb_uint8_t param)
+{
+	LOG_INF ("joined network after %u ms", k_uptime_get_32 ());
+	joined = true;
+	deliver_signal (param ? ZB_BDB_SIGNAL_DEVICE_REBOOT : ZB_BDB_SIGNAL_DEVICE_FIRST_START, RET_OK);
+	ZB_SCHEDULE_APP_ALARM_CANCEL (poll_alarm, ZB_ALARM_ANY_PARAM);
+	ZB_SCHEDULE_APP_ALARM (poll_alarm, 0, ZB_MILLISECONDS_TO_BEACON_INTERVAL(long_poll_ms));
+}
+
+static void leave_cb (zb_uint8_t param)
+{
+	ZVUNUSED(param);
+
+	LOG_INF ("left network");
+	joined = false;
+	ZB_SCHEDULE_APP_ALARM_CANCEL (poll_alarm, ZB_ALARM_ANY_PARAM);
+	deliver_signal (ZB_ZDO_SIGNAL_LEAVE, RET_OK);
+}
+
+void zb_fake_leave (void)
+{
+	ZB_SCHEDULE_APP_CALLBACK (leave_cb, 0);
+}
+
+void zb_fake_rejoin (void)
+{
+	ZB_SCHEDULE_APP_ALARM (join_alarm, 1, ZB_MILLISECONDS_TO_BEACON_INTERVAL(CONFIG_ZBOSS_FAKE_JOIN_DELAY_MS));
+}
+
+void zb_channel_list_init (zb_channel_list_t channel_list)
+{
+	memset (channel_list, 0, sizeof(zb_channel_list_t));
+}
+
+zb_ret_t zb_channel_page_list_set_2_4GHz_mask (zb_channel_list_t channel_list, zb_uint32_t mask)
+{
+	channel_list[0] = mask;
+	return RET_OK;
+}
+
+// the network answers a rejoin on its channel only
+void zdo_initiate_rejoin (zb_bufid_t buf, zb_uint8_t *ext_pan_id, zb_channel_list_t channels_list,
+                          zb_bool_t secure_rejoin)
+{
+	zb_ext_pan_id_t now;
+
+	ZVUNUSED(secure_rejoin);
+	zb_buf_free (buf);
+	zb_get_extended_pan_id (now);
+
+	if (joined || !(channels_list[0] & BIT(FAKE_CHANNEL)) || (memcmp (now, ext_pan_id, sizeof(now)) != 0)) {
+		LOG_INF ("rejoin on 0x%08x found no network", channels_list[0]);
+		return;
+	}
+
+	ZB_SCHEDULE_APP_ALARM_CANCEL (join_alarm, ZB_ALARM_ANY_PARAM);
+	ZB_SCHEDULE_APP_ALARM (join_alarm, 1, ZB_MILLISECONDS_TO_BEACON_INTERVAL(FAKE_REJOIN_MS));
+}
+
+// the rejoin scans every channel and takes as long as joining at start
+zb_bool_t zb_zdo_rejoin_backoff_start (zb_bool_t insecure_rejoin)
+{
+	ZVUNUSED(insecure_rejoin);
+
+	if (joined) {
+		return ZB_FALSE;
+	}
+
+	ZB_SCHEDULE_APP_ALARM_CANCEL (join_alarm, ZB_ALARM_ANY_PARAM);
+	ZB_SCHEDULE_APP_ALARM (join_alarm, 1, ZB_MILLISECONDS_TO_BEACON_INTERVAL(CONFIG_ZBOSS_FAKE_JOIN_DELAY_MS));
+	return ZB_TRUE;
+}
+
+void zb_set_ed_timeout (zb_uint_t timeout)
+{
+	ZVUNUSED(timeout);
+}
+
+void zb_set_keepalive_timeout (zb_uint_t timeout)
+{
+	ZVUNUSED(timeout);
+}
+
+void zb_set_rx_on_when_idle (zb_bool_t rx_on)
+{
+	ZVUNUSED(rx_on);
+}
+
+void zb_set_bdb_primary_channel_set (zb_uint32_t channel_mask)
+{
+	LOG_DBG ("primary channel set 0x%08x", channel_mask);
+}
+
+void zb_set_bdb_secondary_channel_set (zb_uint32_t channel_mask)
+{
+	LOG_DBG ("secondary channel set 0x%08x", channel_mask);
+}
+
+zb_uint8_t zb_get_current_channel (void)
+{
+	return joined ? FAKE_CHANNEL : 0;
+}
+
+zb_uint16_t zb_get_pan_id (void)
+{
+	return joined ? FAKE_PAN_ID : 0xffff;
+}
+
+void zb_get_extended_pan_id (zb_ext_pan_id_t ext_pan_id)
+{
+	static const zb_ext_pan_id_t fake_ext_pan_id = { 0x62, 0x1a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+	memcpy (ext_pan_id, fake_ext_pan_id, sizeof(zb_ext_pan_id_t));
+}
+
+zb_uint16_t zb_nwk_get_parent (void)
+{
+	return FAKE_PARENT;
+}
+
+zb_ret_t zb_zdo_get_diag_data (zb_uint16_t short_address, zb_uint8_t *lqi, zb_int8_t *rssi)
+{
+	if (short_address != FAKE_PARENT) {
+		return RET_NOT_FOUND;
+	}
+
+	*lqi = FAKE_PARENT_LQI;
+	*rssi = FAKE_PARENT_RSSI;
+	return RET_OK;
+}
+
+void zb_zdo_pim_set_long_poll_interval (zb_time_t ms)
+{
+	long_poll_ms = MAX(ms, 1U);
+
+	if (joined) {
+		ZB_SCHEDULE_APP_ALARM_CANCEL (poll_alarm, ZB_ALARM_ANY_PARAM);
+		ZB_SCHEDULE_APP_ALARM (poll_alarm, 0, ZB_MILLISECONDS_TO_BEACON_INTERVAL(long_poll_ms));
+	}
+}
+
+
+//---------------------------------------------------------------------------------------------
+// zcl attributes and reporting
+//
+
+void zb_fake_register_device_ctx (zb_af_device_ctx_t *ctx)
+{
+	device_ctx = ctx;
+}
+
+static zb_af_endpoint_desc_t *find_ep (zb_uint8_t ep)
+{
+	if (device_ctx == NULL) {
+		return NULL;
+	}
+	for (int i = 0; i < device_ctx->ep_count; i++) {
+		if (device_ctx->ep_desc_list[i]->ep_id == ep) {
+			return device_ctx->ep_desc_list[i];
+		}
+	}
+	return NULL;
+}
+
+zb_zcl_attr_t *zb_zcl_get_attr_desc_a (zb_uint8_t ep, zb_uint16_t cluster_id, zb_uint8_t cluster_role,
+                                       zb_uint16_t attr_id)
+{
+	zb_af_endpoint_desc_t *ep_desc = find_ep (ep);
+
+	if (ep_desc == NULL) {
+		return NULL;
+	}
+
+	for (int i = 0; i < ep_desc->cluster_count; i++) {
+		zb_zcl_cluster_desc_t *cluster = &ep_desc->cluster_desc_list[i];
+
+		if ((cluster->cluster_id != cluster_id) || (cluster->role_mask != cluster_role)) {
+			continue;
+		}
+		for (int j = 0; j < cluster->attr_count; j++) {
+			if (cluster->attr_desc_list[j].id == attr_id) {
+				return &cluster->attr_desc_list[j];
+			}
+		}
+	}
+	return NULL;
+}
+
+zb_uint8_t zb_zcl_get_attribute_size (zb_uint8_t attr_type, zb_uint8_t *attr_value)
+{
+	switch (attr_type) {
+	case ZB_ZCL_ATTR_TYPE_BOOL:
+	case ZB_ZCL_ATTR_TYPE_8BITMAP:
+	case ZB_ZCL_ATTR_TYPE_U8:
+	case ZB_ZCL_ATTR_TYPE_S8:
+	case ZB_ZCL_ATTR_TYPE_8BIT_ENUM:
+		return 1;
+	case ZB_ZCL_ATTR_TYPE_16BITMAP:
+	case ZB_ZCL_ATTR_TYPE_U16:
+	case ZB_ZCL_ATTR_TYPE_S16:
+		return 2;
+	case ZB_ZCL_ATTR_TYPE_32BITMAP:
+	case ZB_ZCL_ATTR_TYPE_U32:
+		return 4;
+	case ZB_ZCL_ATTR_TYPE_OCTET_STRING:
+	case ZB_ZCL_ATTR_TYPE_CHAR_STRING:
+		return attr_value[0] + 1;
+	default:
+		return 0;
+	}
+}
+
+zb_uint8_t *zb_zcl_put_value_to_packet (zb_uint8_t *cmd_ptr, zb_uint8_t attr_type, zb_uint8_t *attr_value)
+{
+	zb_uint8_t size = zb_zcl_get_attribute_size (attr_type, attr_value);
+
+	// both the attribute storage and the air format are little endian
+	memcpy (cmd_ptr, attr_value, size);
+	return cmd_ptr + size;
+}
+
+static zb_zcl_reporting_info_t *find_rep_info (zb_uint8_t ep, zb_uint16_t cluster_id, zb_uint8_t cluster_role,
+                                               zb_uint16_t attr_id)
+{
+	zb_af_endpoint_desc_t *ep_desc = find_ep (ep);
+
+	if (ep_desc == NULL) {
+		return NULL;
+	}
+	for (int i = 0; i < ep_desc->rep_info_count; i++) {
+		zb_zcl_reporting_info_t *info = &ep_desc->reporting_info[i];
+		if ((info->flags & ZB_ZCL_REPORTING_SLOT_BUSY) && (info->ep == ep) &&
+		    (info->cluster_id == cluster_id) && (info->cluster_role == cluster_role) &&
+		    (info->attr_id == attr_id)) {
+			return info;
+		}
+	}
+	return NULL;
+}
+
+zb_uint8_t zb_zcl_set_attr_val (zb_uint8_t ep, zb_uint16_t cluster_id, zb_uint8_t cluster_role,
+                                zb_uint16_t attr_id, zb_uint8_t *value, zb_bool_t check_access)
+{
+	ZVUNUSED(check_access);
+
+	zb_zcl_attr_t *attr = zb_zcl_get_attr_desc_a (ep, cluster_id, cluster_role, attr_id);
+	if (attr == NULL) {
+		return ZB_ZCL_STATUS_UNSUP_ATTRIB;
+	}
+
+	size_t size = zb_zcl_get_attribute_size (attr->type, value);
+	bool changed = memcmp (attr->data_p, value, size) != 0;
+	memcpy (attr->data_p, value, size);
+
+	// reportable attributes are marked for reporting when they change
+	if (changed && (attr->access & ZB_ZCL_ATTR_ACCESS_REPORTING)) {
+		zb_zcl_mark_attr_for_reporting (ep, cluster_id, cluster_role, attr_id);
+	}
+
+	return ZB_ZCL_STATUS_SUCCESS;
+}
+
+void zb_zcl_mark_attr_for_reporting (zb_uint8_t ep, zb_uint16_t cluster_id, zb_uint8_t cluster_role,
+                                     zb_uint16_t attr_id)
+{
+	zb_zcl_reporting_info_t *info = find_rep_info (ep, cluster_id, cluster_role, attr_id);
+
+	if (info != NULL) {
+		info->flags |= ZB_ZCL_REPORT_ATTR;
+	}
+}
+
+zb_ret_t zb_zcl_put_reporting_info (zb_zcl_reporting_info_t *rep_info_ptr, zb_bool_t override)
+{
+	zb_af_endpoint_desc_t *ep_desc = find_ep (rep_info_ptr->ep);
+	zb_zcl_reporting_info_t *slot;
+
+	if (ep_desc == NULL) {
+		return RET_INVALID_PARAMETER_1;
+	}
+
+	slot = find_rep_info (rep_info_ptr->ep, rep_info_ptr->cluster_id, rep_info_ptr->cluster_role,
+	                      rep_info_ptr->attr_id);
+	if ((slot != NULL) && !override) {
+		return RET_OK;
+	}
+
+	for (int i = 0; (slot == NULL) && (i < ep_desc->rep_info_count); i++) {
+		if (!(ep_desc->reporting_info[i].flags & ZB_ZCL_REPORTING_SLOT_BUSY)) {
+			slot = &ep_desc->reporting_info[i];
+		}
+	}
+	if (slot == NULL) {
+		return RET_NO_MEMORY;
+	}
+
+	*slot = *rep_info_ptr;
+	slot->flags = ZB_ZCL_REPORTING_SLOT_BUSY;
+	slot->run_time = k_uptime_get_32 ();
+	return RET_OK;
+}
+
+zb_ret_t zb_zcl_start_attr_reporting (zb_uint8_t ep, zb_uint16_t cluster_id, zb_uint8_t cluster_role,
+                                      zb_uint16_t attr_id)
+{
+	zb_zcl_reporting_info_t *info = find_rep_info (ep, cluster_id, cluster_role, attr_id);
+
+	if (info == NULL) {
+		return RET_NOT_FOUND;
+	}
+	info->flags |= ZB_ZCL_REPORT_IS_ALLOWED;
+	return RET_OK;
+}
+
+zb_ret_t zb_zcl_stop_attr_reporting (zb_uint8_t ep, zb_uint16_t cluster_id, zb_uint8_t cluster_role,
+                                     zb_uint16_t attr_id)
+{
+	zb_zcl_reporting_info_t *info = find_rep_info (ep, cluster_id, cluster_role, attr_id);
+
+	if (info == NULL) {
+		return RET_NOT_FOUND;
+	}
+	info->flags &= ~ZB_ZCL_REPORT_IS_ALLOWED;
+	return RET_OK;
+}
+
+zb_zcl_reporting_info_t *zb_zcl_get_reporting_info (zb_uint8_t slot_number)
+{
+	zb_af_endpoint_desc_t *ep_desc;
+
+	if ((device_ctx == NULL) || (device_ctx->ep_count == 0)) {
+		return NULL;
+	}
+	ep_desc = device_ctx->ep_desc_list[0];
+	if (slot_number >= ep_desc->rep_info_count) {
+		return NULL;
+	}
+	return &ep_desc->reporting_info[slot_number];
+}
+
+zb_zcl_reporting_info_t *zb_zcl_find_reporting_info (zb_uint8_t ep, zb_uint16_t cluster_id,
+                                                     zb_uint8_t cluster_role, zb_uint16_t attr_id)
+{
+	return find_rep_info (ep, cluster_id, cluster_role, attr_id);
+}
+
+// send every report that is due, one report attributes frame per attribute, and return the
+// time until the next periodic report
+static int64_t run_reports (void)
+{
+	int64_t next = INT64_MAX;
+	uint32_t now = k_uptime_get_32 ();
+
+	if ((device_ctx == NULL) || !joined) {
+		return next;
+	}
+
+	for (int e = 0; e < device_ctx->ep_count; e++) {
+		zb_af_endpoint_desc_t *ep_desc = device_ctx->ep_desc_list[e];
+
+		for (int i = 0; i < ep_desc->rep_info_count; i++) {
+			zb_zcl_reporting_info_t *info = &ep_desc->reporting_info[i];
+			uint32_t since = now - info->run_time;
+			uint32_t min_ms = info->u.send_info.min_interval * 1000U;
+			uint32_t max_ms = info->u.send_info.max_interval * 1000U;
+			bool due;
+
+			if (!(info->flags & ZB_ZCL_REPORTING_SLOT_BUSY) ||
+			    !(info->flags & ZB_ZCL_REPORT_IS_ALLOWED) ||
+			    (info->direction != ZB_ZCL_CONFIGURE_REPORTING_SEND_REPORT)) {
+				continue;
+			}
+
+			due = ((info->flags & ZB_ZCL_REPORT_ATTR) && (since >= min_ms)) ||
+			      ((max_ms != 0) && (since >= max_ms));
+
+			if (due) {
+				struct zb_fake_frame frame = {
+					.time_ms = now,
+					.kind = ZB_FAKE_FRAME_REPORT,
+					.src_ep = info->ep,
+					.dst_ep = info->dst.endpoint,
+					.dst_addr = info->dst.short_addr,
+					.cluster_id = info->cluster_id,
+					.attr_id = info->attr_id,
+					.attr_count = 1,
+				};
+				record_frame (&frame);
+				info->flags &= ~ZB_ZCL_REPORT_ATTR;
+				info->run_time = now;
+				since = 0;
+			}
+
+			if (info->flags & ZB_ZCL_REPORT_ATTR) {
+				next = MIN(next, (int64_t)(min_ms - since));
+			}
+			if (max_ms != 0) {
+				next = MIN(next, (int64_t)(max_ms - since));
+			}
+		}
+	}
+
+	return next;
+}
+
+
+//---------------------------------------------------------------------------------------------
+// zcl commands and identify
+//
+
+BUILD_ASSERT(sizeof(zb_zcl_command_send_status_t) <= FAKE_BUF_PARAM_WORDS * sizeof(uint32_t),
+             "send status does not fit the buffer parameter area");
+
+// whether the aps ack of a unicast frame sent now arrives. every
+// CONFIG_ZBOSS_FAKE_APS_NO_ACK_EVERY th frame sent goes unacknowledged.
+static bool aps_acked (void)
+{
+	aps_frames++;
+	if ((CONFIG_ZBOSS_FAKE_APS_NO_ACK_EVERY > 0) &&
+	    ((aps_frames % CONFIG_ZBOSS_FAKE_APS_NO_ACK_EVERY) == 0)) {
+		aps_missed++;
+		return false;
+	}
+	return true;
+}
+
+// hand the outcome of a unicast frame to the command's callback
+static void send_confirm (zb_bufid_t buf, bool acked, zb_uint8_t dst_ep, zb_uint8_t ep,
+                          zb_callback_t cb)
+{
+	if (cb == NULL) {
+		zb_buf_free (buf);
+		return;
+	}
+
+	zb_zcl_command_send_status_t *status = ZB_BUF_GET_PARAM(buf, zb_zcl_command_send_status_t);
+	status->status = acked ? RET_OK : RET_ERROR;
+	status->dst_endpoint = dst_ep;
+	status->src_endpoint = ep;
+	ZB_SCHEDULE_APP_CALLBACK (cb, buf);
+}
+
+void zb_fake_send_cmd (zb_bufid_t buf, zb_uint16_t dst_addr, zb_uint8_t dst_ep, zb_uint8_t ep,
+                       zb_uint16_t cluster_id, zb_uint8_t cmd_id, zb_callback_t cb)
+{
+	bool acked = false;
+
+	if (joined) {
+		acked = aps_acked ();
+
+		struct zb_fake_frame frame = {
+			.time_ms = k_uptime_get_32 (),
+			.kind = ZB_FAKE_FRAME_ZCL_CMD,
+			.src_ep = ep,
+			.dst_ep = dst_ep,
+			.cmd_id = cmd_id,
+			.dst_addr = dst_addr,
+			.cluster_id = cluster_id,
+			.acked = acked,
+		};
+		record_frame (&frame);
+		LOG_DBG ("t=%u cluster 0x%04x cmd %u", frame.time_ms, cluster_id, cmd_id);
+	} else {
+		LOG_WRN ("not joined, cluster 0x%04x cmd %u dropped", cluster_id, cmd_id);
+	}
+
+	send_confirm (buf, acked, dst_ep, ep, cb);
+}
+
+zb_uint8_t zb_fake_next_tsn (void)
+{
+	return tsn++;
+}
+
+void zb_fake_send_frame (zb_bufid_t buf, zb_uint16_t dst_addr, zb_uint8_t dst_ep, zb_uint8_t ep,
+                         zb_uint16_t cluster_id, zb_callback_t cb)
+{
+	const zb_uint8_t *payload = bufs[buf].payload;
+	zb_uint8_t len = bufs[buf].len;
+
+	// frame control, sequence number and command id; manufacturer specific frames carry the
+	// manufacturer code in between
+	size_t pos = (payload[0] & 0x04) ? 5 : 3;
+	bool sent = joined && (len >= pos);
+	bool acked = false;
+
+	if (sent) {
+		acked = aps_acked ();
+
+		struct zb_fake_frame frame = {
+			.time_ms = k_uptime_get_32 (),
+			.kind = ZB_FAKE_FRAME_ZCL_CMD,
+			.src_ep = ep,
+			.dst_ep = dst_ep,
+			.cmd_id = payload[pos - 1],
+			.dst_addr = dst_addr,
+			.cluster_id = cluster_id,
+			.acked = acked,
+		};
+
+		// count the attribute records of general report attributes frames
+		if (((payload[0] & 0x03) == 0) && (frame.cmd_id == ZB_ZCL_CMD_REPORT_ATTRIB)) {
+			frame.kind = ZB_FAKE_FRAME_REPORT;
+			frame.attr_id = payload[pos] | (payload[pos + 1] << 8);
+			while (pos + 3 <= len) {
+				pos += 3 + zb_zcl_get_attribute_size (payload[pos + 2], (zb_uint8_t *)&payload[pos + 3]);
+				frame.attr_count++;
+			}
+		}
+
+		record_frame (&frame);
+		LOG_DBG ("t=%u cluster 0x%04x cmd %u, %u bytes", frame.time_ms, cluster_id, frame.cmd_id, len);
+	} else {
+		LOG_WRN ("not joined, cluster 0x%04x frame dropped", cluster_id);
+	}
+
+	send_confirm (buf, acked, dst_ep, ep, cb);
+}
+
+void zb_fake_set_identify_handler (zb_uint8_t ep, zb_callback_t handler)
+{
+	identify_ep = ep;
+	identify_handler = handler;
+}
+
+void zb_fake_set_endpoint_handler (zb_uint8_t ep, zb_device_handler_t handler)
+{
+	zb_af_endpoint_desc_t *ep_desc = find_ep (ep);
+
+	if (ep_desc != NULL) {
+		ep_desc->device_handler = handler;
+	}
+}
+
+static void identify_end (zb_uint8_t param)
+{
+	zb_uint16_t identify_time = ZB_ZCL_IDENTIFY_IDENTIFY_TIME_DEFAULT_VALUE;
+
+	ZVUNUSED(param);
+
+	zb_zcl_set_attr_val (identify_ep, ZB_ZCL_CLUSTER_ID_IDENTIFY, ZB_ZCL_CLUSTER_SERVER_ROLE,
+	                     ZB_ZCL_ATTR_IDENTIFY_IDENTIFY_TIME_ID, (zb_uint8_t *)&identify_time, ZB_FALSE);
+	if (identify_handler != NULL) {
+		identify_handler (0);
+	}
+}
+
+zb_ret_t zb_bdb_finding_binding_target (zb_uint8_t endpoint)
+{
+	zb_uint16_t identify_time = FAKE_IDENTIFY_TIME_S;
+
+	if (!joined || (endpoint != identify_ep)) {
+		return RET_INVALID_STATE;
+	}
+
+	zb_zcl_set_attr_val (endpoint, ZB_ZCL_CLUSTER_ID_IDENTIFY, ZB_ZCL_CLUSTER_SERVER_ROLE,
+	                     ZB_ZCL_ATTR_IDENTIFY_IDENTIFY_TIME_ID, (zb_uint8_t *)&identify_time, ZB_FALSE);
+	if (identify_handler != NULL) {
+		identify_handler (endpoint);
+	}
+	ZB_SCHEDULE_APP_ALARM (identify_end, 0, ZB_MILLISECONDS_TO_BEACON_INTERVAL(FAKE_IDENTIFY_TIME_S * 1000));
+	return RET_OK;
+}
+
+void zb_bdb_finding_binding_target_cancel (void)
+{
+	if (ZB_SCHEDULE_APP_ALARM_CANCEL (identify_end, ZB_ALARM_ANY_PARAM) == RET_OK) {
+		identify_end (0);
+	}
+}
+
+
+//---------------------------------------------------------------------------------------------
+// zigbee application utilities
+//
+
+zb_ret_t zigbee_default_signal_handler (zb_bufid_t bufid)
+{
+	ZVUNUSED(bufid);
+	return RET_OK;
+}
+
+void zigbee_erase_persistent_storage (zb_bool_t erase)
+{
+	ZVUNUSED(erase);
+}
+
+void zigbee_configure_sleepy_behavior (bool enable)
+{
+	ZVUNUSED(enable);
+}
+
+void user_input_indicate (void)
+{
+}
+
+static void factory_reset_alarm (zb_uint8_t param)
+{
+	ZVUNUSED(param);
+
+	LOG_INF ("factory reset");
+	factory_reset_done = true;
+}
+
+void register_factory_reset_button (uint32_t button)
+{
+	factory_reset_button = button;
+}
+
+void check_factory_reset_button (uint32_t button_state, uint32_t has_changed)
+{
+	if (!(has_changed & factory_reset_button)) {
+		return;
+	}
+
+	if (button_state & factory_reset_button) {
+		factory_reset_done = false;
+		ZB_SCHEDULE_APP_ALARM (factory_reset_alarm, 0, ZB_MILLISECONDS_TO_BEACON_INTERVAL(FAKE_FACTORY_RESET_MS));
+	} else {
+		ZB_SCHEDULE_APP_ALARM_CANCEL (factory_reset_alarm, ZB_ALARM_ANY_PARAM);
+	}
+}
+
+bool was_factory_reset_done (void)
+{
+	return factory_reset_done;
+}
+
+void zb_fake_error_check_failed (zb_ret_t err_code, const char *file, int line)
+{
+	LOG_ERR ("ZB_ERROR_CHECK failed: %d at %s:%d", err_code, file, line);
+	k_panic ();
+}
+
+
+//---------------------------------------------------------------------------------------------
+// fake zboss thread
+//
+
+static void run_cb (const struct cb_entry *entry)
+{
+	switch (entry->type) {
+	case CB_SINGLE:
+		((zb_callback_t)entry->func) (entry->param);
+		break;
+	case CB_DOUBLE:
+		((zb_callback2_t)entry->func) (entry->param, entry->user_param);
+		break;
+	default:
+		break;
+	}
+}
+
+static void fake_thread_main (void *p1, void *p2, void *p3)
+{
+	ZVUNUSED(p1);
+	ZVUNUSED(p2);
+	ZVUNUSED(p3);
+
+	deliver_signal (ZB_ZDO_SIGNAL_SKIP_STARTUP, RET_OK);
+	ZB_SCHEDULE_APP_ALARM (join_alarm, 0, ZB_MILLISECONDS_TO_BEACON_INTERVAL(CONFIG_ZBOSS_FAKE_JOIN_DELAY_MS));
+
+	for (;;) {
+		struct cb_entry entry;
+		int64_t next = MIN(run_alarms (), run_reports ());
+		k_timeout_t timeout = (next == INT64_MAX) ? K_FOREVER : K_MSEC(MAX(next, 0));
+
+		if (k_msgq_get (&cb_queue, &entry, timeout) == 0) {
+			run_cb (&entry);
+		}
+	}
+}
+
+void zigbee_enable (void)
+{
+	k_thread_create (&fake_thread, fake_stack, K_THREAD_STACK_SIZEOF(fake_stack),
+	                 fake_thread_main, NULL, NULL, NULL,
+	                 FAKE_THREAD_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set (&fake_thread, "zboss_fake");
+}
+
+
+//---------------------------------------------------------------------------------------------
+// fake saadc: converts the virtual battery voltage
+//
+
+uint32_t zb_fake_battery_mv (void)
+{
+	uint64_t hours = k_uptime_get () / (3600 * 1000);
+	uint64_t drop_mv = (hours * CONFIG_ZBOSS_FAKE_BATTERY_DRAIN_UV_PER_HOUR) / 1000;
+
+	return (drop_mv >= CONFIG_ZBOSS_FAKE_BATTERY_MV) ? 0 : (uint32_t)(CONFIG_ZBOSS_FAKE_BATTERY_MV - drop_mv);
+}
+
+nrfx_err_t nrfx_saadc_init (uint8_t interrupt_priority)
+{
+	ZVUNUSED(interrupt_priority);
+
+	saadc_buffer = NULL;
+	saadc_handler = NULL;
+	return NRFX_SUCCESS;
+}
+
+void nrfx_saadc_uninit (void)
+{
+}
+
+nrfx_err_t nrfx_saadc_channel_config (nrfx_saadc_channel_t const *p_channel)
+{
+	saadc_input = p_channel->pin_p;
+	return NRFX_SUCCESS;
+}
+
+nrfx_err_t nrfx_saadc_simple_mode_set (uint32_t channel_mask, nrf_saadc_resolution_t resolution,
+                                       nrf_saadc_oversample_t oversampling,
+                                       nrfx_saadc_event_handler_t event_handler)
+{
+	ZVUNUSED(channel_mask);
+	ZVUNUSED(resolution);
+	ZVUNUSED(oversampling);
+
+	saadc_handler = event_handler;
+	return NRFX_SUCCESS;
+}
+
+nrfx_err_t nrfx_saadc_buffer_set (nrf_saadc_value_t *p_buffer, uint16_t size)
+{
+	ZVUNUSED(size);
+
+	saadc_buffer = p_buffer;
+	return NRFX_SUCCESS;
+}
+
+nrfx_err_t nrfx_saadc_mode_trigger (void)
+{
+	if (saadc_buffer == NULL) {
+		return NRFX_ERROR_INVALID_STATE;
+	}
+
+	// 14 bit result, gain 1/6 and 0.6 V internal reference give a 3.6 V full scale, 18 V
+	// of vddh on the divide by 5 input
+	uint32_t full_scale_mv = (saadc_input == NRF_SAADC_INPUT_VDDHDIV5) ? (3600 * 5) : 3600;
+
+	*saadc_buffer = (nrf_saadc_value_t)MIN((zb_fake_battery_mv () << 14) / full_scale_mv,
+	                                       (1 << 14) - 1);
+
+	if (saadc_handler != NULL) {
+		nrfx_saadc_evt_t event = {
+			.type = NRFX_SAADC_EVT_DONE,
+			.data.done = { .p_buffer = saadc_buffer, .size = 1 },
+		};
+		saadc_handler (&event);
+		event.type = NRFX_SAADC_EVT_FINISHED;
+		saadc_handler (&event);
+	}
+
+	return NRFX_SUCCESS;
+}
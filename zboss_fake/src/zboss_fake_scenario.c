@@ -0,0 +1,424 @@
+//---------------------------------------------------------------------------------------------
+// scripted input scenarios
+//
+// Once the fake stack has joined, presses the buttons devicetree inputs through the gpio
+// emulator, logs the resulting traffic summary and ends the simulation. The presses scenario
+// presses the inputs round robin. The checking scenarios compare the on/off commands recorded
+// for every edge against the press-command and release-command properties of the inputs and
+// end with "scenario: PASS" and exit code 0, or with exit code 1 at the first mismatch.
+//
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/logging/log.h>
+
+#include <posix_board_if.h>
+
+#include <zboss_api.h>
+#include "zboss_fake.h"
+
+LOG_MODULE_DECLARE (zboss_fake, CONFIG_ZBOSS_FAKE_LOG_LEVEL);
+
+#define BUTTONS_NODE DT_PATH(buttons)
+
+#define GPIO_SPEC_AND_COMMA(button) GPIO_DT_SPEC_GET(button, gpios),
+
+static const struct gpio_dt_spec buttons[] = {
+#if DT_NODE_EXISTS(BUTTONS_NODE)
+	DT_FOREACH_CHILD(BUTTONS_NODE, GPIO_SPEC_AND_COMMA)
+#endif
+};
+
+BUILD_ASSERT(CONFIG_ZBOSS_FAKE_SCENARIO_INPUTS <= ARRAY_SIZE(buttons),
+             "more scenario inputs than buttons in the devicetree");
+
+// drive the physical level of a button so it reads as pressed or released
+static void set_button (const struct gpio_dt_spec *button, bool pressed)
+{
+	bool active_low = (button->dt_flags & GPIO_ACTIVE_LOW) != 0;
+
+	gpio_emul_input_set (button->port, button->pin, pressed != active_low);
+}
+
+// emulated inputs start low, which reads as pressed for active low buttons. release every
+// button before the application samples them.
+static int release_buttons (void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(buttons); i++) {
+		gpio_pin_configure_dt (&buttons[i], GPIO_INPUT);
+		set_button (&buttons[i], false);
+	}
+	return 0;
+}
+
+SYS_INIT (release_buttons, POST_KERNEL, CONFIG_APPLICATION_INIT_PRIORITY);
+
+// log the summary and end the simulation
+static void scenario_exit (int status)
+{
+	zb_fake_print_summary ();
+
+	if (status == 0) {
+		LOG_INF ("scenario: PASS");
+	}
+
+	// let the log thread flush before leaving
+	k_sleep (K_SECONDS(1));
+	posix_exit (status);
+}
+
+#ifndef CONFIG_ZBOSS_FAKE_SCENARIO_PRESSES
+
+// commands an edge of the input sends, -1 for none
+#define BUTTON_CMDS_AND_COMMA(button) \
+	{ DT_PROP_OR(button, press_command, -1), DT_PROP_OR(button, release_command, -1) },
+
+static const struct {
+	int press;
+	int release;
+} button_cmds[] = {
+#if DT_NODE_EXISTS(BUTTONS_NODE)
+	DT_FOREACH_CHILD(BUTTONS_NODE, BUTTON_CMDS_AND_COMMA)
+#endif
+};
+
+// index of the first recorded frame not checked yet
+static uint32_t frame_cursor;
+
+// start checking with the next frame recorded
+static void frames_skip (void)
+{
+	frame_cursor = zb_fake_frame_total ();
+}
+
+// copy up to max of the on/off cluster frames recorded since the last call, oldest first.
+// returns the number copied, or -1 when some frame was overwritten before it was checked.
+static int frames_take_on_off (struct zb_fake_frame *frames, size_t max)
+{
+	struct zb_fake_frame frame;
+	size_t count = 0;
+
+	for (; frame_cursor < zb_fake_frame_total (); frame_cursor++) {
+		if (!zb_fake_frame_at (frame_cursor, &frame)) {
+			LOG_ERR ("scenario: frame %u overwritten before it was checked", frame_cursor);
+			return -1;
+		}
+		if ((frame.kind == ZB_FAKE_FRAME_ZCL_CMD) && (frame.cluster_id == ZB_ZCL_CLUSTER_ID_ON_OFF) &&
+		    (count < max)) {
+			frames[count++] = frame;
+		}
+	}
+
+	return count;
+}
+
+// command an edge of the input sends, -1 for none
+static int edge_cmd (uint32_t input, bool pressed)
+{
+	return pressed ? button_cmds[input].press : button_cmds[input].release;
+}
+
+#endif
+
+#ifdef CONFIG_ZBOSS_FAKE_SCENARIO_PRESSES
+
+static void scenario_main (void)
+{
+	const int64_t end_ms = (int64_t)CONFIG_ZBOSS_FAKE_SCENARIO_HOURS * 3600 * 1000;
+	uint32_t presses = 0;
+
+	while (!ZB_JOINED ()) {
+		k_sleep (K_MSEC(100));
+	}
+
+	LOG_INF ("scenario: %u inputs, one press every %u s for %u h",
+	         CONFIG_ZBOSS_FAKE_SCENARIO_INPUTS, CONFIG_ZBOSS_FAKE_SCENARIO_PRESS_INTERVAL_S,
+	         CONFIG_ZBOSS_FAKE_SCENARIO_HOURS);
+
+	while (k_uptime_get () < end_ms) {
+		const struct gpio_dt_spec *button = &buttons[presses % CONFIG_ZBOSS_FAKE_SCENARIO_INPUTS];
+
+		set_button (button, true);
+		k_sleep (K_MSEC(CONFIG_ZBOSS_FAKE_SCENARIO_HOLD_MS));
+		set_button (button, false);
+		presses++;
+
+		k_sleep (K_SECONDS(CONFIG_ZBOSS_FAKE_SCENARIO_PRESS_INTERVAL_S));
+	}
+
+	LOG_INF ("scenario: %u presses", presses);
+	scenario_exit (0);
+}
+
+#endif
+
+#ifdef CONFIG_ZBOSS_FAKE_SCENARIO_SIMULTANEOUS
+
+BUILD_ASSERT(CONFIG_ZBOSS_FAKE_SCENARIO_INPUTS >= 2, "pairs need two scenario inputs");
+
+// virtual time from the edges to checking their commands; the settle time plus the work
+// queue and stack scheduler passes
+#define EDGE_CHECK_MS 100
+
+BUILD_ASSERT(EDGE_CHECK_MS < CONFIG_ZBOSS_FAKE_SCENARIO_HOLD_MS, "press checked after release");
+
+// inputs of the step th pair, walking every pair of scenario inputs in turn
+static uint32_t pair_inputs (uint32_t step)
+{
+	const uint32_t n = CONFIG_ZBOSS_FAKE_SCENARIO_INPUTS;
+	uint32_t k = step % (n * (n - 1) / 2);
+
+	for (uint32_t a = 0; a < n; a++) {
+		if (k < n - 1 - a) {
+			return BIT(a) | BIT(a + 1 + k);
+		}
+		k -= n - 1 - a;
+	}
+
+	return 0;
+}
+
+// drive the levels of several buttons on one port with a single write, so the emulator
+// raises one interrupt callback with every changed pin in its mask
+static bool set_buttons (uint32_t inputs, bool pressed)
+{
+	const struct device *port = NULL;
+	gpio_port_pins_t pins = 0;
+	gpio_port_value_t values = 0;
+
+	for (size_t i = 0; i < CONFIG_ZBOSS_FAKE_SCENARIO_INPUTS; i++) {
+		if ((inputs & BIT(i)) == 0) {
+			continue;
+		}
+		if ((port != NULL) && (port != buttons[i].port)) {
+			LOG_ERR ("scenario: inputs 0x%x are not on one gpio port", inputs);
+			return false;
+		}
+		port = buttons[i].port;
+		pins |= BIT(buttons[i].pin);
+		if (pressed != ((buttons[i].dt_flags & GPIO_ACTIVE_LOW) != 0)) {
+			values |= BIT(buttons[i].pin);
+		}
+	}
+
+	return gpio_emul_input_set_masked (port, pins, values) == 0;
+}
+
+// every input of the mask sent the command of its edge exactly once, in input order
+static bool check_edges (uint32_t inputs, bool pressed)
+{
+	struct zb_fake_frame frames[2 * CONFIG_ZBOSS_FAKE_SCENARIO_INPUTS];
+	int count = frames_take_on_off (frames, ARRAY_SIZE(frames));
+	int n = 0;
+
+	if (count < 0) {
+		return false;
+	}
+
+	for (uint32_t i = 0; i < CONFIG_ZBOSS_FAKE_SCENARIO_INPUTS; i++) {
+		int cmd = edge_cmd (i, pressed);
+
+		if (((inputs & BIT(i)) == 0) || (cmd < 0)) {
+			continue;
+		}
+		if ((n >= count) || (frames[n].cmd_id != cmd)) {
+			LOG_ERR ("scenario: inputs 0x%x %s, command %d of input %u missing", inputs,
+			         pressed ? "pressed" : "released", cmd, i);
+			return false;
+		}
+		n++;
+	}
+
+	if (n != count) {
+		LOG_ERR ("scenario: inputs 0x%x %s, %d unexpected commands", inputs,
+		         pressed ? "pressed" : "released", count - n);
+		return false;
+	}
+
+	return true;
+}
+
+static void scenario_main (void)
+{
+	const int64_t end_ms = (int64_t)CONFIG_ZBOSS_FAKE_SCENARIO_HOURS * 3600 * 1000;
+	uint32_t steps = 0;
+
+	while (!ZB_JOINED ()) {
+		k_sleep (K_MSEC(100));
+	}
+
+	LOG_INF ("scenario: pairs of %u inputs pressed together every %u s for %u h",
+	         CONFIG_ZBOSS_FAKE_SCENARIO_INPUTS, CONFIG_ZBOSS_FAKE_SCENARIO_PRESS_INTERVAL_S,
+	         CONFIG_ZBOSS_FAKE_SCENARIO_HOURS);
+
+	while (k_uptime_get () < end_ms) {
+		uint32_t inputs = pair_inputs (steps);
+
+		frames_skip ();
+		if (!set_buttons (inputs, true)) {
+			scenario_exit (1);
+		}
+		k_sleep (K_MSEC(EDGE_CHECK_MS));
+		if (!check_edges (inputs, true)) {
+			scenario_exit (1);
+		}
+
+		k_sleep (K_MSEC(CONFIG_ZBOSS_FAKE_SCENARIO_HOLD_MS - EDGE_CHECK_MS));
+		frames_skip ();
+		if (!set_buttons (inputs, false)) {
+			scenario_exit (1);
+		}
+		k_sleep (K_MSEC(EDGE_CHECK_MS));
+		if (!check_edges (inputs, false)) {
+			scenario_exit (1);
+		}
+		steps++;
+
+		k_sleep (K_SECONDS(CONFIG_ZBOSS_FAKE_SCENARIO_PRESS_INTERVAL_S));
+	}
+
+	LOG_INF ("scenario: %u pairs pressed", steps);
+	scenario_exit (0);
+}
+
+#endif
+
+#ifdef CONFIG_ZBOSS_FAKE_SCENARIO_NO_ACK
+
+BUILD_ASSERT(CONFIG_ZBOSS_FAKE_APS_NO_ACK_EVERY > 0, "no frame would go unacknowledged");
+
+#define RETRIES CONFIG_APP_RELIABLE_SEND_RETRIES
+
+static uint32_t delivered;
+static uint32_t retried;
+static uint32_t given_up;
+
+// virtual time from an edge until its command is acked or given up: the backoffs of the
+// application's retries plus a second for the scheduler passes
+static uint32_t delivery_window_ms (void)
+{
+	uint32_t window_ms = 1000;
+
+	for (uint32_t k = 0; k < RETRIES; k++) {
+		window_ms += MIN((uint32_t)CONFIG_APP_RELIABLE_SEND_BACKOFF_MS << k,
+		                 (uint32_t)CONFIG_APP_RELIABLE_SEND_BACKOFF_MAX_MS);
+	}
+
+	return window_ms;
+}
+
+// the command of the edge was sent until acked, and sent again only when the target may
+// see it twice
+static bool check_delivery (uint32_t input, bool pressed)
+{
+	struct zb_fake_frame frames[RETRIES + 2];
+	int count = frames_take_on_off (frames, ARRAY_SIZE(frames));
+	int cmd = edge_cmd (input, pressed);
+	bool repeatable = (cmd == ZB_ZCL_CMD_ON_OFF_OFF_ID) || (cmd == ZB_ZCL_CMD_ON_OFF_ON_ID);
+	const char *edge = pressed ? "press" : "release";
+
+	if (count < 0) {
+		return false;
+	}
+
+	if (cmd < 0) {
+		if (count != 0) {
+			LOG_ERR ("scenario: input %u %s has no command, %d sent", input, edge, count);
+			return false;
+		}
+		return true;
+	}
+
+	if (count == 0) {
+		LOG_ERR ("scenario: input %u %s, command %d missing", input, edge, cmd);
+		return false;
+	}
+
+	for (int i = 0; i < count; i++) {
+		if (frames[i].cmd_id != cmd) {
+			LOG_ERR ("scenario: input %u %s, command %u sent instead of %d", input, edge,
+			         frames[i].cmd_id, cmd);
+			return false;
+		}
+		if (frames[i].acked && (i + 1 < count)) {
+			LOG_ERR ("scenario: input %u %s, command %d sent again after its ack", input, edge, cmd);
+			return false;
+		}
+	}
+
+	if (!repeatable && (count > 1)) {
+		LOG_ERR ("scenario: input %u %s, command %d sent %d times", input, edge, cmd, count);
+		return false;
+	}
+
+	if (repeatable && !frames[count - 1].acked && (count != RETRIES + 1)) {
+		LOG_ERR ("scenario: input %u %s, command %d given up after %d of %d attempts", input, edge,
+		         cmd, count, RETRIES + 1);
+		return false;
+	}
+
+	retried += count - 1;
+	if (frames[count - 1].acked) {
+		delivered++;
+	} else {
+		given_up++;
+	}
+
+	return true;
+}
+
+static void scenario_main (void)
+{
+	const int64_t end_ms = (int64_t)CONFIG_ZBOSS_FAKE_SCENARIO_HOURS * 3600 * 1000;
+	const uint32_t window_ms = delivery_window_ms ();
+	uint32_t presses = 0;
+
+	while (!ZB_JOINED ()) {
+		k_sleep (K_MSEC(100));
+	}
+
+	LOG_INF ("scenario: %u inputs, one press every %u s for %u h, every %u th frame unacked",
+	         CONFIG_ZBOSS_FAKE_SCENARIO_INPUTS, CONFIG_ZBOSS_FAKE_SCENARIO_PRESS_INTERVAL_S,
+	         CONFIG_ZBOSS_FAKE_SCENARIO_HOURS, CONFIG_ZBOSS_FAKE_APS_NO_ACK_EVERY);
+
+	while (k_uptime_get () < end_ms) {
+		uint32_t input = presses % CONFIG_ZBOSS_FAKE_SCENARIO_INPUTS;
+
+		// hold the press until its command has settled, so its retries are not mixed up
+		// with the release command
+		frames_skip ();
+		set_button (&buttons[input], true);
+		k_sleep (K_MSEC(window_ms));
+		if (!check_delivery (input, true)) {
+			scenario_exit (1);
+		}
+
+		frames_skip ();
+		set_button (&buttons[input], false);
+		k_sleep (K_MSEC(window_ms));
+		if (!check_delivery (input, false)) {
+			scenario_exit (1);
+		}
+		presses++;
+
+		k_sleep (K_SECONDS(CONFIG_ZBOSS_FAKE_SCENARIO_PRESS_INTERVAL_S));
+	}
+
+	LOG_INF ("scenario: %u presses, %u commands delivered, %u given up, %u retries", presses,
+	         delivered, given_up, retried);
+
+	if (retried == 0) {
+		LOG_ERR ("scenario: no command was retried");
+		scenario_exit (1);
+	}
+
+	scenario_exit (0);
+}
+
+#endif
+
+K_THREAD_DEFINE (zboss_fake_scenario, 2048, scenario_main, NULL, NULL, NULL,
+                 K_PRIO_PREEMPT(10), 0, 0);
@@ -0,0 +1,33 @@
+#ifndef __BATTERY_H__
+#define __BATTERY_H__
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// called from the zboss thread with the measured supply voltage
+typedef void (*battery_done_t)(int32_t mv);
+
+void battery_init (void);
+
+// start one non-blocking conversion of the supply voltage. returns -EBUSY while the
+// previous conversion is still running.
+int battery_sample_start (battery_done_t done);
+
+// remaining capacity in zigbee half percent steps for a supply voltage in mV, from the
+// curve of the chemistry selected in Kconfig
+uint8_t battery_level_from_mv (int32_t mv);
+
+// time from the start of the most recent conversion to its completion event
+uint32_t battery_conversion_us (void);
+
+// total time battery_sample_start () has spent on the calling thread since boot
+uint32_t battery_caller_us (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
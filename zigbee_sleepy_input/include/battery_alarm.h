@@ -0,0 +1,23 @@
+#ifndef __BATTERY_ALARM_H__
+#define __BATTERY_ALARM_H__
+
+#include <zboss_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// where the alarm commands go
+void battery_alarm_init (zb_uint8_t ep, zb_uint16_t dst_addr, zb_uint8_t dst_ep);
+
+// evaluate the power configuration thresholds against a new battery sample, update the
+// battery alarm state attribute and send an alarm command for each enabled alarm that was
+// just raised. voltage in 100 mV and percentage in half percent steps, as in the
+// attributes. zboss thread only.
+void battery_alarm_update (zb_uint8_t voltage, zb_uint8_t percent);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef __BATTERY_CURVES_H__
+#define __BATTERY_CURVES_H__
+
+// Remaining capacity of each supported chemistry against the voltage at the saadc input,
+// in zigbee half percent steps. Each curve is a chain of straight segments, highest
+// voltage first, and evaluates to a constant expression so battery.c can expand it into
+// a lookup table with one entry per mV between the _MIN_MV and _MAX_MV endpoints.
+// _LUT_SIZE must be a literal (_MAX_MV - _MIN_MV + 1) for LISTIFY.
+
+// capacity above the highest point of a curve
+#define BATTERY_CURVE_TOP(mv, v0, c0) \
+	((mv) > (v0)) ? (c0) :
+
+// linear interpolation between two neighbouring points, v0 > v1
+#define BATTERY_CURVE_SEG(mv, v0, c0, v1, c1) \
+	((mv) > (v1)) ? ((((mv) - (v1)) * ((c0) - (c1)) / ((v0) - (v1))) + (c1)) :
+
+// capacity at and below the lowest point of a curve
+#define BATTERY_CURVE_BOTTOM(c1) \
+	(c1)
+
+// CR2032 coin cell. The values are an average of those found in the CR2032 datasheets
+// from Energizer, Maxell and Panasonic, via the thunderboard react.
+#define BATTERY_CURVE_CR2032_MIN_MV   2000
+#define BATTERY_CURVE_CR2032_MAX_MV   3000
+#define BATTERY_CURVE_CR2032_LUT_SIZE 1001
+
+#define BATTERY_CURVE_CR2032(mv) ( \
+	BATTERY_CURVE_TOP(mv, 3000, 200) \
+	BATTERY_CURVE_SEG(mv, 3000, 200, 2900, 160) \
+	BATTERY_CURVE_SEG(mv, 2900, 160, 2800, 120) \
+	BATTERY_CURVE_SEG(mv, 2800, 120, 2700,  80) \
+	BATTERY_CURVE_SEG(mv, 2700,  80, 2600,  60) \
+	BATTERY_CURVE_SEG(mv, 2600,  60, 2500,  40) \
+	BATTERY_CURVE_SEG(mv, 2500,  40, 2400,  20) \
+	BATTERY_CURVE_SEG(mv, 2400,  20, 2000,   0) \
+	BATTERY_CURVE_BOTTOM(0))
+
+// Two lithium iron disulfide AAA cells in series powering VDD directly. The flat
+// 1.5 V plateau holds most of the capacity and the knee comes late.
+#define BATTERY_CURVE_AAA_LITHIUM_MIN_MV   2000
+#define BATTERY_CURVE_AAA_LITHIUM_MAX_MV   3400
+#define BATTERY_CURVE_AAA_LITHIUM_LUT_SIZE 1401
+
+#define BATTERY_CURVE_AAA_LITHIUM(mv) ( \
+	BATTERY_CURVE_TOP(mv, 3400, 200) \
+	BATTERY_CURVE_SEG(mv, 3400, 200, 3100, 180) \
+	BATTERY_CURVE_SEG(mv, 3100, 180, 3000, 140) \
+	BATTERY_CURVE_SEG(mv, 3000, 140, 2900, 100) \
+	BATTERY_CURVE_SEG(mv, 2900, 100, 2800,  60) \
+	BATTERY_CURVE_SEG(mv, 2800,  60, 2600,  20) \
+	BATTERY_CURVE_SEG(mv, 2600,  20, 2000,   0) \
+	BATTERY_CURVE_BOTTOM(0))
+
+// Single cell lithium polymer pack powering VDDH, measured on the VDDHDIV5 input.
+#define BATTERY_CURVE_LIPO_MIN_MV   3000
+#define BATTERY_CURVE_LIPO_MAX_MV   4200
+#define BATTERY_CURVE_LIPO_LUT_SIZE 1201
+
+#define BATTERY_CURVE_LIPO(mv) ( \
+	BATTERY_CURVE_TOP(mv, 4200, 200) \
+	BATTERY_CURVE_SEG(mv, 4200, 200, 4100, 180) \
+	BATTERY_CURVE_SEG(mv, 4100, 180, 4000, 160) \
+	BATTERY_CURVE_SEG(mv, 4000, 160, 3900, 130) \
+	BATTERY_CURVE_SEG(mv, 3900, 130, 3800, 100) \
+	BATTERY_CURVE_SEG(mv, 3800, 100, 3700,  60) \
+	BATTERY_CURVE_SEG(mv, 3700,  60, 3600,  20) \
+	BATTERY_CURVE_SEG(mv, 3600,  20, 3500,  10) \
+	BATTERY_CURVE_SEG(mv, 3500,  10, 3000,   0) \
+	BATTERY_CURVE_BOTTOM(0))
+
+#endif
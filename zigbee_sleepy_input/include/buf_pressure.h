@@ -0,0 +1,72 @@
+#ifndef __BUF_PRESSURE_H__
+#define __BUF_PRESSURE_H__
+
+#include <zephyr/types.h>
+#include <zboss_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// send an on/off command that was held back; return RET_OK once its buffer is requested
+typedef zb_ret_t (*buf_pressure_send_t)(zb_uint8_t input, zb_uint16_t cmd_id, uint32_t edge_cycles);
+
+// buffer pressure counters since boot
+struct buf_pressure_stats {
+	uint32_t waiting_max;       // most buffer requests queued in the zboss scheduler at once
+	uint32_t in_use_max;        // most buffers held by the application at once
+	uint32_t failures;          // buffer requests zboss refused
+	uint32_t coalesced;         // held commands folded into an earlier one for the same input
+	uint32_t dropped;           // held commands dropped to make room for newer ones
+	uint32_t memory_low;        // times zb_buf_memory_low () was found set after being clear
+	uint32_t oom;               // times zb_buf_is_oom_state () was found set after being clear
+};
+
+#ifdef CONFIG_APP_BUF_PRESSURE
+
+void buf_pressure_init (buf_pressure_send_t send);
+
+// zb_buf_get_out_delayed_ext for the application's frames. func must call
+// buf_pressure_granted when it runs and buf_pressure_freed once the buffer is back or
+// handed to the stack. zboss thread only.
+zb_ret_t buf_pressure_get (zb_callback2_t func, zb_uint16_t param);
+
+// a requested buffer arrived
+void buf_pressure_granted (void);
+
+// a granted buffer is back; sends held commands while there is room
+void buf_pressure_freed (void);
+
+// the outstanding buffer requests reached CONFIG_APP_BUF_PRESSURE_LIMIT, zboss refused the
+// last one, or zboss reports its buffer pool low or exhausted
+bool buf_pressure_high (void);
+
+// hold back a command while the pressure is high or earlier commands are still held, and
+// return true. a command for an input that already has one held is folded into it when the
+// light ends up in the same state; when the hold queue is full the oldest command is dropped.
+bool buf_pressure_hold (zb_uint8_t input, zb_uint16_t cmd_id, uint32_t edge_cycles);
+
+const struct buf_pressure_stats *buf_pressure_stats (void);
+
+#else
+
+static inline void buf_pressure_init (buf_pressure_send_t send) { }
+static inline zb_ret_t buf_pressure_get (zb_callback2_t func, zb_uint16_t param)
+{
+	return zb_buf_get_out_delayed_ext (func, param, 0);
+}
+static inline void buf_pressure_granted (void) { }
+static inline void buf_pressure_freed (void) { }
+static inline bool buf_pressure_high (void) { return false; }
+static inline bool buf_pressure_hold (zb_uint8_t input, zb_uint16_t cmd_id, uint32_t edge_cycles)
+{
+	return false;
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
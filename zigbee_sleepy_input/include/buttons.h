@@ -0,0 +1,26 @@
+#ifndef __BUTTONS_H__
+#define __BUTTONS_H__
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// called from the zboss thread, never from interrupt context
+typedef void (*button_handler_t)(uint32_t button_state, uint32_t has_changed);
+
+void buttons_init (button_handler_t button_handler);
+void dk_read_buttons (uint32_t *button_state, uint32_t *has_changed);
+
+// k_cycle_get_32 () timestamp of the edge currently being passed to the button handler
+uint32_t buttons_event_cycles (void);
+
+// number of edges dropped because the interrupt to zboss thread ring was full
+uint32_t buttons_overflow_count (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
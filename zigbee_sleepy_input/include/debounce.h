@@ -0,0 +1,26 @@
+#ifndef __DEBOUNCE_H__
+#define __DEBOUNCE_H__
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// returns the raw state of all inputs, one bit per input
+typedef uint32_t (*debounce_sample_t)(void);
+
+// called from timer interrupt context with the settled state of all inputs and the
+// k_cycle_get_32 () timestamp of the first edge of the oldest burst that just settled
+typedef void (*debounce_report_t)(uint32_t state, uint32_t cycles);
+
+void debounce_init (debounce_sample_t sample, debounce_report_t report, uint32_t initial_state);
+
+// restart the settle time of the given inputs; safe to call from interrupt context
+void debounce_kick (uint32_t inputs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
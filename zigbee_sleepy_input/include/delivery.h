@@ -0,0 +1,54 @@
+#ifndef __DELIVERY_H__
+#define __DELIVERY_H__
+
+#include <zephyr/types.h>
+#include <zboss_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// build and send one command in bufid; the command's callback calls delivery_confirm
+typedef void (*delivery_send_t)(zb_bufid_t bufid, zb_uint16_t cmd_id);
+
+// delivery counters of one destination endpoint
+struct delivery_stats {
+	zb_uint8_t dst_ep;
+	uint32_t sent;              // commands given a slot; delivered, failed or still in flight
+	uint32_t delivered;         // commands acknowledged, possibly after retries
+	uint32_t failed;            // commands given up after the last retry
+	uint32_t untracked;         // commands sent once without a slot, every slot being in use
+	uint32_t retries;           // attempts after the first
+	uint32_t latency_ms_sum;    // first attempt to aps ack, summed over delivered commands
+	uint32_t latency_ms_max;
+};
+
+#ifdef CONFIG_APP_RELIABLE_SEND
+
+void delivery_init (delivery_send_t send);
+
+// get a buffer and send the command; a command without an aps ack is sent again after a
+// backoff that doubles with every retry. without CONFIG_APP_EVENT_STAMPS only on and off
+// are retried, as a second copy of any other command acts on the target twice. zboss
+// thread only.
+zb_ret_t delivery_send (zb_uint8_t dst_ep, zb_uint16_t cmd_id);
+
+// aps confirm of a command; reads the send status in bufid but does not free it. returns
+// false while the command will be sent again, true once it is delivered or given up.
+bool delivery_confirm (zb_bufid_t bufid);
+
+// counters of a destination endpoint, NULL before the first command to it
+const struct delivery_stats *delivery_stats (zb_uint8_t dst_ep);
+
+#else
+
+static inline void delivery_init (delivery_send_t send) { }
+static inline bool delivery_confirm (zb_bufid_t bufid) { return true; }
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
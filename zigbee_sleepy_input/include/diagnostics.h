@@ -0,0 +1,31 @@
+#ifndef __DIAGNOSTICS_H__
+#define __DIAGNOSTICS_H__
+
+#include <zephyr/types.h>
+#include <zboss_api.h>
+
+#include "zb_app_diagnostics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// count into the diagnostics cluster's attribute storage from now on
+void diagnostics_init (zb_zcl_app_diagnostics_attrs_t *attrs);
+
+// aps confirm of a unicast frame; reads the send status in bufid but does not free it. also
+// refreshes the parent link quality, the radio counters and the poll estimate while the device
+// is awake.
+void diagnostics_confirm (zb_bufid_t bufid);
+
+// joined a network; counts a parent other than the last one
+void diagnostics_joined (void);
+
+// the stack gave up on the link to the parent
+void diagnostics_parent_link_failure (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
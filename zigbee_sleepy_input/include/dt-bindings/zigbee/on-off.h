@@ -0,0 +1,10 @@
+#ifndef __DT_BINDINGS_ZIGBEE_ON_OFF_H__
+#define __DT_BINDINGS_ZIGBEE_ON_OFF_H__
+
+// zcl on/off cluster command ids for the press-command and release-command properties of
+// bikerglen,gpio-keys children
+#define ZCL_ON_OFF_CMD_OFF      0x00
+#define ZCL_ON_OFF_CMD_ON       0x01
+#define ZCL_ON_OFF_CMD_TOGGLE   0x02
+
+#endif
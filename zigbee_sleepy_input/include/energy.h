@@ -0,0 +1,48 @@
+#ifndef __ENERGY_H__
+#define __ENERGY_H__
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// energy relevant events the application causes, each costing a fixed charge
+enum energy_event {
+	ENERGY_EVENT_TX,            // frame sent by the application
+	ENERGY_EVENT_POLL,          // data request to the parent
+	ENERGY_EVENT_SAADC,         // battery voltage conversion
+	ENERGY_EVENT_WAKEUP,        // wake from system on sleep
+	ENERGY_EVENT_COUNT,
+};
+
+#ifdef CONFIG_APP_ENERGY_ACCOUNTING
+
+// count one event; safe from any thread
+void energy_count (enum energy_event event);
+
+// long poll interval in effect from now on, 0 while not polling. polls are counted from
+// the time spent at each interval.
+void energy_set_poll_interval (uint32_t interval_ms);
+
+// fold elapsed polls, led on-time and sleep current into the totals
+void energy_update (void);
+
+// totals as of the last energy_update ()
+uint32_t energy_events (enum energy_event event);
+uint32_t energy_led_on_time_ms (void);
+uint32_t energy_consumed_uah (void);
+
+#else
+
+static inline void energy_count (enum energy_event event) { }
+static inline void energy_set_poll_interval (uint32_t interval_ms) { }
+static inline void energy_update (void) { }
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
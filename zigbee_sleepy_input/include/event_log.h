@@ -0,0 +1,52 @@
+#ifndef __EVENT_LOG_H__
+#define __EVENT_LOG_H__
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// one input event held back while the device is not joined
+struct event_log_entry {
+	uint32_t time_ms;           // uptime at the edge
+	uint16_t boot;              // boot the uptime belongs to
+	uint16_t cmd_id;            // command the edge sends
+	uint8_t input;              // input bit position
+};
+
+// send one replayed event; return 0, or a negative error to retry it with the next batch
+typedef int (*event_log_send_t)(const struct event_log_entry *entry);
+
+// find the replay position and the boot number in the flash log, and record this boot.
+// starts over from what the flash log holds, as after a reboot, when called again.
+int event_log_init (event_log_send_t send);
+
+// hold back an event whose edge was at uptime time_ms. when the ram queue is full, the
+// queued events are appended to the flash log in one go. zboss thread only.
+void event_log_push (uint8_t input, uint16_t cmd_id, uint32_t time_ms);
+
+// events are held back; new events must queue behind them to keep their order
+bool event_log_pending (void);
+
+// after joining, replay the held back events oldest first in rate limited batches
+void event_log_replay_start (void);
+
+// stop replaying after leaving the network
+void event_log_replay_stop (void);
+
+// age of an event in ms, or -1 when its edge was before the last reboot
+int64_t event_log_age_ms (const struct event_log_entry *entry);
+
+// number of this boot, one more than the highest in the flash log. a record is written at
+// every boot, so it advances even when no events were held back.
+uint16_t event_log_boot (void);
+
+// events lost because both the ram queue and the flash log were full
+uint32_t event_log_dropped (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
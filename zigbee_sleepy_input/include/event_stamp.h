@@ -0,0 +1,85 @@
+#ifndef __EVENT_STAMP_H__
+#define __EVENT_STAMP_H__
+
+#include <zephyr/types.h>
+#include <zboss_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Manufacturer specific on/off cluster command, client to server, sent in place of the
+// plain command of an input event:
+//
+//   uint8   on/off cluster command id the event stands for
+//   uint8   input bit position
+//   uint16  boot number from the event log, advancing at every boot
+//   uint32  event sequence number, counting from 0 at boot
+//   uint32  ms from the edge to building the frame, EVENT_STAMP_AGE_UNKNOWN when the edge
+//           was before the last reboot
+//
+// A retry carries the same boot and sequence number and a new age, so the coordinator
+// drops it when (boot, sequence number) was seen already.
+#define ZB_ZCL_CMD_ON_OFF_APP_EVENT_ID  0xE0
+
+#define EVENT_STAMP_AGE_UNKNOWN         0xFFFFFFFF
+
+// on/off command id of the parameter event_stamp_add returns
+#define EVENT_STAMP_CMD(param)          ((zb_uint8_t)((param) & 0xFF))
+
+struct event_stamp {
+	uint32_t seq;
+	uint32_t time_ms;           // uptime at the edge
+	zb_bufid_t bufid;           // buffer of the attempt in the air, ZB_BUF_INVALID otherwise
+	zb_uint8_t input;
+	bool time_known;            // false for an edge before the last reboot
+	bool used;
+};
+
+#ifdef CONFIG_APP_EVENT_STAMPS
+
+// number an input event and remember when its edge was. age_ms < 0 when the edge was
+// before the last reboot. sets param to the parameter to request its frame's buffer with:
+// the low byte of the command id and the stamp in the high byte. the stamp is kept until
+// event_stamp_done or event_stamp_drop; RET_NO_MEMORY while every stamp is in use.
+zb_ret_t event_stamp_add (zb_uint8_t input, zb_uint16_t cmd_id, int64_t age_ms, zb_uint16_t *param);
+
+// no frame was requested for the event after all; its number is given to the next one
+void event_stamp_drop (zb_uint16_t param);
+
+// stamp of a frame parameter, NULL when it is not in use
+const struct event_stamp *event_stamp_get (zb_uint16_t param);
+
+// the frame of a stamp is being sent in bufid
+void event_stamp_sent (zb_uint16_t param, zb_bufid_t bufid);
+
+// the frame sent in bufid is acknowledged or given up; its stamp is free again
+void event_stamp_done (zb_bufid_t bufid);
+
+// ms since the edge, or EVENT_STAMP_AGE_UNKNOWN
+uint32_t event_stamp_age_ms (const struct event_stamp *stamp);
+
+#else
+
+static inline zb_ret_t event_stamp_add (zb_uint8_t input, zb_uint16_t cmd_id, int64_t age_ms,
+                                        zb_uint16_t *param)
+{
+	*param = cmd_id;
+	return RET_OK;
+}
+static inline void event_stamp_drop (zb_uint16_t param) { }
+static inline const struct event_stamp *event_stamp_get (zb_uint16_t param) { return NULL; }
+static inline void event_stamp_sent (zb_uint16_t param, zb_bufid_t bufid) { }
+static inline void event_stamp_done (zb_bufid_t bufid) { }
+static inline uint32_t event_stamp_age_ms (const struct event_stamp *stamp)
+{
+	return EVENT_STAMP_AGE_UNKNOWN;
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
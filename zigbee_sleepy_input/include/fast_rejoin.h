@@ -0,0 +1,58 @@
+#ifndef __FAST_REJOIN_H__
+#define __FAST_REJOIN_H__
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef CONFIG_APP_FAST_REJOIN
+
+// load the network cached in settings and have steering scan its channel before every
+// other channel. call before zigbee_enable ().
+int fast_rejoin_init (void);
+
+// joined: time the join and cache the network if it changed. zboss thread only.
+void fast_rejoin_joined (void);
+
+// the network was lost; time the rejoin from now
+void fast_rejoin_lost (void);
+
+// the parent is lost: rejoin the cached network on its channel alone, and fall back to the
+// stack's rejoin over every channel when that finds nothing. false when no network is cached
+// or no buffer was available; the default signal handler's rejoin is left to run then.
+bool fast_rejoin_start (void);
+
+// the device left the network on purpose; forget the cached network
+void fast_rejoin_forget (void);
+
+// the stack slept for ms while not joined, with the radio off
+void fast_rejoin_slept (uint32_t ms);
+
+// ms from boot or from losing the network to the last join, and the estimated part of it
+// spent with the radio on
+uint32_t fast_rejoin_join_ms (void);
+uint32_t fast_rejoin_radio_ms (void);
+
+// rejoins on the cached channel that found the network, and those that fell back to the
+// stack's rejoin over every channel
+uint32_t fast_rejoin_cached_joins (void);
+uint32_t fast_rejoin_cached_failures (void);
+
+#else
+
+static inline int fast_rejoin_init (void) { return 0; }
+static inline void fast_rejoin_joined (void) { }
+static inline void fast_rejoin_lost (void) { }
+static inline bool fast_rejoin_start (void) { return false; }
+static inline void fast_rejoin_forget (void) { }
+static inline void fast_rejoin_slept (uint32_t ms) { }
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef __GESTURE_H__
+#define __GESTURE_H__
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// gestures recognised on one input
+enum gesture {
+	GESTURE_SINGLE,             // one short press
+	GESTURE_DOUBLE,             // two short presses within the multi-press window
+	GESTURE_TRIPLE,             // three short presses within the multi-press window
+	GESTURE_LONG,               // held for the long press time
+	GESTURE_HOLD,               // still held, repeated every hold repeat interval
+	GESTURE_LONG_RELEASE,       // released after a long press
+	GESTURE_COUNT,
+};
+
+// a gesture was recognised on input. edge_cycles is the k_cycle_get_32 () timestamp of the
+// release or the timeout that completed it, so the time spent waiting for the multi-press
+// window or the long press time is not counted as latency.
+typedef void (*gesture_handler_t)(uint8_t input, enum gesture gesture, uint32_t edge_cycles);
+
+void gesture_init (gesture_handler_t handler);
+
+// feed one debounced edge of input, at edge_cycles. zboss thread only.
+void gesture_edge (uint8_t input, bool pressed, uint32_t edge_cycles);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
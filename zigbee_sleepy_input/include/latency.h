@@ -0,0 +1,65 @@
+#ifndef __LATENCY_H__
+#define __LATENCY_H__
+
+#include <zephyr/types.h>
+#include <zboss_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// stages between the first gpio edge of an input change and its frame being confirmed
+enum latency_stage {
+	LATENCY_STAGE_SETTLE,       // gpio edge to debounced change queued by the timer interrupt
+	LATENCY_STAGE_DISPATCH,     // debounced change queued to button_handler running
+	LATENCY_STAGE_BUFFER,       // button_handler to light_switch_send_on_off getting a buffer
+	LATENCY_STAGE_AIR,          // light_switch_send_on_off to the aps confirm of the frame
+	LATENCY_STAGE_TOTAL,        // gpio edge to the aps confirm of the frame
+	LATENCY_STAGE_COUNT,
+};
+
+// histogram bucket 0 counts samples under 1 ms, bucket n counts [2^(n-1), 2^n) ms and
+// the last bucket everything longer
+#define LATENCY_BUCKET_COUNT 16
+
+// size of one stage's octet string attribute: length byte plus one u16 count per bucket
+#define LATENCY_ATTR_SIZE (1 + 2 * LATENCY_BUCKET_COUNT)
+
+#ifdef CONFIG_APP_LATENCY_PROBES
+
+// add one sample between two k_cycle_get_32 () timestamps; safe from interrupt context
+void latency_record (enum latency_stage stage, uint32_t start_cycles, uint32_t end_cycles);
+
+// a buffer was requested with frame parameter param for the command of an input change
+// whose first edge was at edge_cycles
+void latency_cmd_queued (zb_uint16_t param, uint32_t edge_cycles);
+
+// light_switch_send_on_off got bufid for a frame parameter; frames never queued, such as
+// retries, are not timed
+void latency_cmd_sending (zb_uint16_t param, zb_bufid_t bufid);
+
+// the frame sent in bufid was confirmed
+void latency_cmd_sent (zb_bufid_t bufid);
+
+// copy a stage's histogram into a zcl octet string of LATENCY_ATTR_SIZE bytes
+void latency_encode (enum latency_stage stage, zb_uint8_t *octets);
+
+// print every histogram over rtt
+void latency_dump (void);
+
+#else
+
+static inline void latency_record (enum latency_stage stage, uint32_t start_cycles, uint32_t end_cycles) { }
+static inline void latency_cmd_queued (zb_uint16_t param, uint32_t edge_cycles) { }
+static inline void latency_cmd_sending (zb_uint16_t param, zb_bufid_t bufid) { }
+static inline void latency_cmd_sent (zb_bufid_t bufid) { }
+static inline void latency_encode (enum latency_stage stage, zb_uint8_t *octets) { }
+static inline void latency_dump (void) { }
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
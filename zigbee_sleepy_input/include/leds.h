@@ -12,6 +12,9 @@ void led_set (uint8_t led_idx, uint32_t val);
 void led_set_on (uint8_t led_idx);
 void led_set_off (uint8_t led_idx);
 
+// total time any led has been lit since boot, summed over leds
+uint32_t led_on_time_ms (void);
+
 #ifdef __cplusplus
 }
 #endif
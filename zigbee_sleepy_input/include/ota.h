@@ -0,0 +1,48 @@
+#ifndef __OTA_H__
+#define __OTA_H__
+
+#include <zephyr/types.h>
+#include <zboss_api.h>
+
+#ifdef CONFIG_APP_OTA
+#include <zigbee/zigbee_fota.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// image transfer of the last download
+struct ota_stats {
+	uint32_t image_bytes;       // size of the image the server offered
+	uint32_t bytes;             // image bytes received so far
+	uint32_t transfer_ms;       // from the start of the download to the last block
+	uint32_t bytes_per_s;       // bytes over transfer_ms
+};
+
+#ifdef CONFIG_APP_OTA
+
+// confirm the running image to mcuboot and start the ota upgrade client of the fota library.
+// evt gets every download event after the fast transfer mode has been updated.
+int ota_init (zigbee_fota_callback_t evt);
+
+// pass every zboss signal on to the fota library, before the default signal handler
+void ota_signal (zb_bufid_t bufid);
+
+// zcl device callback with ZB_ZCL_OTA_UPGRADE_VALUE_CB_ID: counts the image blocks, polls
+// fast while a download runs and hands the value to the fota library
+void ota_zcl_value (zb_bufid_t bufid);
+
+const struct ota_stats *ota_stats (void);
+
+#else
+
+static inline void ota_signal (zb_bufid_t bufid) { }
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
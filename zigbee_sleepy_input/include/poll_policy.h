@@ -0,0 +1,39 @@
+#ifndef __POLL_POLICY_H__
+#define __POLL_POLICY_H__
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// poll fast for a while after joining, then back off step by step to the slow interval.
+// zboss thread only.
+void poll_policy_start (void);
+
+// stop polling accounting after leaving the network
+void poll_policy_stop (void);
+
+// user input or other activity that may be followed by downlink traffic: go back to the
+// fast interval and start the back off again
+void poll_policy_kick (void);
+
+// poll at ms until poll_policy_release, whatever else happens, for a transfer that needs
+// fast polls throughout. released, the back off starts again from the fast interval.
+void poll_policy_hold (uint32_t ms);
+void poll_policy_release (void);
+
+// long poll interval in effect, 0 while stopped
+uint32_t poll_policy_interval_ms (void);
+
+// estimates of the data polls made since boot, in total and at intervals shorter than the
+// slow interval: the time spent at each interval divided by the interval. polls the stack
+// adds or skips, e.g. for a frame waiting at the parent, are not seen.
+uint32_t poll_policy_polls_estimate (void);
+uint32_t poll_policy_fast_polls_estimate (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef __REPORTING_H__
+#define __REPORTING_H__
+
+#include <zboss_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// one reportable server attribute of the application's endpoint. unsigned integer and
+// bitmap attributes of up to four octets are supported.
+struct reporting_attr {
+	zb_uint16_t cluster_id;
+	zb_uint16_t attr_id;
+	zb_uint16_t min_interval;   // s between reports of a changing value
+	zb_uint16_t max_interval;   // s between periodic reports, 0 for none, 0xffff for no reports
+	zb_uint32_t delta;          // smallest change reported, 0 for any change
+};
+
+// take the application's reporting table; the table must stay valid
+int reporting_init (zb_uint8_t ep, const struct reporting_attr *table, size_t count);
+
+// install the table as the default configuration in the stack's reporting slots. the stack
+// keeps the intervals and deltas, takes configure reporting commands from the coordinator
+// into them and answers reads of them; the module sends every report itself, periodic ones
+// included, with the intervals and deltas in the slots.
+void reporting_configure (zb_uint16_t dst_addr, zb_uint8_t dst_ep);
+
+// update the value of a table attribute. changes of at least delta are collected until
+// the current zboss callback returns, then every changed attribute of a cluster goes out
+// in a single report attributes frame once its min interval has passed. zboss thread only.
+zb_ret_t reporting_set (zb_uint16_t cluster_id, zb_uint16_t attr_id, const void *value);
+
+// look at a zcl command to the application's endpoint before the stack processes it. after
+// a configure reporting command for a table cluster the stack's own reports are stopped again
+// and the new intervals take effect. call from the endpoint handler.
+void reporting_command (const zb_zcl_parsed_hdr_t *cmd_info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
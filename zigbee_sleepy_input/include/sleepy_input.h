@@ -0,0 +1,55 @@
+#ifndef __SLEEPY_INPUT_H__
+#define __SLEEPY_INPUT_H__
+
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/util.h>
+#include <zboss_api.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SLEEPY_INPUT_BUTTONS_NODE   DT_PATH(buttons)
+
+#define SLEEPY_INPUT_ONE_PLUS(node) 1 +
+
+// inputs that send commands: every child of the gpio-keys node but the last, which is the
+// identify and factory reset button. an input's bit position is its index under the node.
+#define SLEEPY_INPUT_COUNT          (DT_FOREACH_CHILD(SLEEPY_INPUT_BUTTONS_NODE, SLEEPY_INPUT_ONE_PLUS) 0 - 1)
+
+// bit of the identify and factory reset button
+#define SLEEPY_INPUT_IDENTIFY_BUTTON BIT(SLEEPY_INPUT_COUNT)
+
+// marks an edge that does not send a command
+#define SLEEPY_INPUT_NO_CMD         0xFFFF
+
+// set in a command id that is not a standard on/off command; it goes out as a manufacturer
+// specific command of the on/off cluster under APP_MANUF_CODE
+#define SLEEPY_INPUT_CMD_MANUF      BIT(8)
+
+// zcl on/off command ids an input sends when it goes active and inactive
+struct sleepy_input_cmds {
+	zb_uint16_t press;
+	zb_uint16_t release;
+};
+
+#define SLEEPY_INPUT_CMDS_AND_COMMA(node) { \
+	DT_PROP_OR(node, press_command, SLEEPY_INPUT_NO_CMD), \
+	DT_PROP_OR(node, release_command, SLEEPY_INPUT_NO_CMD) },
+
+// dispatch table indexed by input bit position, one entry per gpio-keys child including the
+// identify button. the application defines it with SLEEPY_INPUT_DISPATCH_TABLE_DEFINE (),
+// which builds it from the press-command and release-command properties of the children.
+extern const struct sleepy_input_cmds sleepy_input_dispatch[SLEEPY_INPUT_COUNT + 1];
+
+#define SLEEPY_INPUT_DISPATCH_TABLE_DEFINE() \
+	const struct sleepy_input_cmds sleepy_input_dispatch[SLEEPY_INPUT_COUNT + 1] = { \
+		DT_FOREACH_CHILD(SLEEPY_INPUT_BUTTONS_NODE, SLEEPY_INPUT_CMDS_AND_COMMA) \
+	}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef __SPI_FLASH_H__
+#define __SPI_FLASH_H__
+
+#include <zephyr/types.h>
+#include <zephyr/devicetree.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Some boards carry a spi flash chip that draws far more than the rest of the board while
+// asleep unless it is sent the deep power-down command. Its pins are the gpios of the
+// sw_spi_cs_n, sw_spi_sck, sw_spi_mosi, sw_spi_wr_n and sw_spi_hold_n devicetree nodes.
+
+#if DT_NODE_EXISTS(DT_NODELABEL(sw_spi_cs_n))
+
+// send the deep power-down command and leave every pin driven at its idle level
+void spi_flash_power_down (void);
+
+// time the last spi_flash_power_down took in us
+uint32_t spi_flash_power_down_us (void);
+
+#else
+
+static inline void spi_flash_power_down (void) { }
+static inline uint32_t spi_flash_power_down_us (void) { return 0; }
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef __STACK_WATERMARK_H__
+#define __STACK_WATERMARK_H__
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// high-water mark of one thread stack
+typedef void (*stack_watermark_cb_t)(const char *name, size_t size, size_t unused);
+
+#ifdef CONFIG_APP_STACK_WATERMARKS
+
+// measure every thread's stack, calling cb for each when not NULL. the stacks are scanned
+// for the fill pattern, so this takes a few hundred us.
+void stack_watermark_scan (stack_watermark_cb_t cb);
+
+// smallest headroom of any thread stack in bytes over every scan since boot, 0 before the
+// first scan
+uint32_t stack_watermark_min_unused (void);
+
+#else
+
+static inline void stack_watermark_scan (stack_watermark_cb_t cb) { }
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
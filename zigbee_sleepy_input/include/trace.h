@@ -0,0 +1,86 @@
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// record types. scripts/trace_decode.py reads the enums in this file, so add new values at
+// the end and keep each one on its own line.
+enum trace_type {
+	TRACE_CLOCK,                // cycles is the k_cycle_get_32 () rate in Hz, first of each flush
+	TRACE_LOST,                 // arg records overwritten before they were flushed
+	TRACE_ENTER,                // id enum trace_cb
+	TRACE_EXIT,                 // id enum trace_cb
+	TRACE_SIGNAL,               // arg zboss signal id
+	TRACE_EDGE,                 // arg inputs with a gpio edge, before debouncing
+	TRACE_SETTLED,              // arg input state after debouncing
+	TRACE_TX,                   // id enum trace_tx, arg command or cluster id
+	TRACE_TX_DONE,              // id enum trace_tx, arg aps confirm status
+};
+
+// callbacks run by the zboss scheduler
+enum trace_cb {
+	TRACE_CB_SIGNAL_HANDLER,
+	TRACE_CB_BUTTONS_DRAIN,
+	TRACE_CB_SEND_ON_OFF,
+	TRACE_CB_SEND_ON_OFF_DONE,
+	TRACE_CB_DELIVERY_RETRY,
+	TRACE_CB_REPORTING_FLUSH,
+	TRACE_CB_REPORTING_SENT,
+	TRACE_CB_BATTERY_DONE,
+	TRACE_CB_IDENTIFY_LED,
+};
+
+// frames sent
+enum trace_tx {
+	TRACE_TX_ON_OFF,
+	TRACE_TX_REPORT,
+	TRACE_TX_ALARM,
+};
+
+// one fixed size record, written as is to the rtt channel, little endian
+struct trace_record {
+	uint32_t cycles;            // k_cycle_get_32 ()
+	uint8_t type;               // enum trace_type
+	uint8_t id;
+	uint16_t arg;
+};
+
+#ifdef CONFIG_APP_TRACE
+
+// set up the rtt channel the records are flushed to
+void trace_init (void);
+
+// add one record to the ram ring, overwriting the oldest; safe from interrupt context
+void trace_record (enum trace_type type, uint8_t id, uint16_t arg);
+
+// copy the records added since the last flush to the rtt channel. cheap enough to call
+// every time the device goes to sleep; records that do not fit stay for the next flush.
+void trace_flush (void);
+
+#else
+
+static inline void trace_init (void) { }
+static inline void trace_record (enum trace_type type, uint8_t id, uint16_t arg) { }
+static inline void trace_flush (void) { }
+
+#endif
+
+static inline void trace_cb_enter (enum trace_cb cb)
+{
+	trace_record (TRACE_ENTER, cb, 0);
+}
+
+static inline void trace_cb_exit (enum trace_cb cb)
+{
+	trace_record (TRACE_EXIT, cb, 0);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef __ZB_APP_DIAGNOSTICS_H__
+#define __ZB_APP_DIAGNOSTICS_H__
+
+#include "zb_app_metrics.h"
+
+// Diagnostics cluster server. Its counters are the attribute storage itself, bumped by
+// diagnostics.c where the application already handles the events, and are only ever read
+// on demand: none of them is in the reporting table.
+
+#define ZB_ZCL_APP_DIAGNOSTICS_CLUSTER_REVISION_DEFAULT ((zb_uint16_t)0x0001u)
+
+// attribute-only server; nothing to initialize unless the stack brings its own
+#ifndef ZB_ZCL_CLUSTER_ID_DIAGNOSTICS_SERVER_ROLE_INIT
+#define ZB_ZCL_CLUSTER_ID_DIAGNOSTICS_SERVER_ROLE_INIT (zb_zcl_cluster_init_t)NULL
+#endif
+#ifndef ZB_ZCL_CLUSTER_ID_DIAGNOSTICS_CLIENT_ROLE_INIT
+#define ZB_ZCL_CLUSTER_ID_DIAGNOSTICS_CLIENT_ROLE_INIT (zb_zcl_cluster_init_t)NULL
+#endif
+
+// standard attributes: aps frames acknowledged and given up, and the link quality and signal
+// strength of the parent when the last frame was confirmed. the mac frame and aps retry
+// counts stay inside the stack, so they are left out rather than estimated.
+#define ZB_ZCL_ATTR_APP_DIAGNOSTICS_APS_TX_UCAST_SUCCESS_ID  0x0109
+#define ZB_ZCL_ATTR_APP_DIAGNOSTICS_APS_TX_UCAST_FAIL_ID     0x010B
+#define ZB_ZCL_ATTR_APP_DIAGNOSTICS_LAST_MESSAGE_LQI_ID      0x011C
+#define ZB_ZCL_ATTR_APP_DIAGNOSTICS_LAST_MESSAGE_RSSI_ID     0x011D
+
+// manufacturer specific attributes: transmissions the radio dropped after a busy channel,
+// joins to a parent other than the previous one, an estimate of the data polls made from the
+// time spent at each poll interval, and parent link failures the stack reported after polls
+// went unanswered
+#define ZB_ZCL_ATTR_APP_DIAGNOSTICS_CCA_FAILURES_ID          0xF000
+#define ZB_ZCL_ATTR_APP_DIAGNOSTICS_PARENT_CHANGES_ID        0xF001
+#define ZB_ZCL_ATTR_APP_DIAGNOSTICS_POLLS_ESTIMATE_ID        0xF002
+#define ZB_ZCL_ATTR_APP_DIAGNOSTICS_POLL_FAILURES_ID         0xF003
+
+// attribute storage for the diagnostics cluster
+struct zb_zcl_app_diagnostics_attrs {
+	zb_uint16_t aps_tx_ucast_success;
+	zb_uint16_t aps_tx_ucast_fail;
+	zb_uint8_t last_message_lqi;
+	zb_int8_t last_message_rssi;
+	zb_uint32_t cca_failures;
+	zb_uint16_t parent_changes;
+	zb_uint32_t polls_estimate;
+	zb_uint32_t poll_failures;
+};
+
+typedef struct zb_zcl_app_diagnostics_attrs zb_zcl_app_diagnostics_attrs_t;
+
+// Declare a read only attribute of the diagnostics cluster
+#define ZB_ZCL_SET_APP_DIAGNOSTICS_ATTR_DESC(attr_id, data_ptr, attr_type) \
+	ZB_ZCL_SET_ATTR_DESC_M((attr_id), (data_ptr), (attr_type), ZB_ZCL_ATTR_ACCESS_READ_ONLY)
+
+// Declare a read only manufacturer specific attribute of the diagnostics cluster
+#define ZB_ZCL_SET_APP_DIAGNOSTICS_MANUF_ATTR_DESC(attr_id, data_ptr, attr_type) \
+	{ (attr_id), (attr_type), ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC, \
+	  APP_MANUF_CODE, (void *)(data_ptr) },
+
+#endif // __ZB_APP_DIAGNOSTICS_H__
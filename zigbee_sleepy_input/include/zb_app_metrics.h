@@ -0,0 +1,157 @@
+#ifndef __ZB_APP_METRICS_H__
+#define __ZB_APP_METRICS_H__
+
+#include "latency.h"
+#include "energy.h"
+
+// Manufacturer specific cluster carrying the optional on-device measurements. The cluster
+// only exists when at least one of the measurements is enabled in Kconfig.
+
+#if defined(CONFIG_APP_LATENCY_PROBES) || defined(CONFIG_APP_ENERGY_ACCOUNTING) || \
+    defined(CONFIG_APP_RELIABLE_SEND) || defined(CONFIG_APP_FAST_REJOIN) || \
+    defined(CONFIG_APP_STACK_WATERMARKS) || defined(CONFIG_APP_BUF_PRESSURE) || \
+    defined(CONFIG_APP_OTA)
+#define APP_METRICS_CLUSTER 1
+#endif
+
+// manufacturer code used for the cluster and its attributes
+#define APP_MANUF_CODE                                0x1234
+
+#define ZB_ZCL_CLUSTER_ID_APP_METRICS                 0xFC00
+#define ZB_ZCL_APP_METRICS_CLUSTER_REVISION_DEFAULT   ((zb_uint16_t)0x0001u)
+
+// no cluster specific commands, so nothing to initialize in either role
+#define ZB_ZCL_CLUSTER_ID_APP_METRICS_SERVER_ROLE_INIT (zb_zcl_cluster_init_t)NULL
+#define ZB_ZCL_CLUSTER_ID_APP_METRICS_CLIENT_ROLE_INIT (zb_zcl_cluster_init_t)NULL
+
+// latency histograms, one octet string per enum latency_stage
+#define ZB_ZCL_ATTR_APP_METRICS_LATENCY_BASE_ID       0x0000
+#define ZB_ZCL_ATTR_APP_METRICS_LATENCY_ID(stage)     (ZB_ZCL_ATTR_APP_METRICS_LATENCY_BASE_ID + (stage))
+
+// energy accounting, one u32 event count per enum energy_event, led on-time in ms and the
+// estimated charge consumed in uAh
+#define ZB_ZCL_ATTR_APP_METRICS_ENERGY_EVENTS_BASE_ID 0x0100
+#define ZB_ZCL_ATTR_APP_METRICS_ENERGY_EVENTS_ID(event) (ZB_ZCL_ATTR_APP_METRICS_ENERGY_EVENTS_BASE_ID + (event))
+#define ZB_ZCL_ATTR_APP_METRICS_LED_ON_TIME_ID        0x0110
+#define ZB_ZCL_ATTR_APP_METRICS_CONSUMED_UAH_ID       0x0111
+
+// battery sampling: duration of the last conversion and the total time spent starting
+// conversions on the system workqueue, both in us
+#define ZB_ZCL_ATTR_APP_METRICS_SAADC_CONVERSION_US_ID 0x0200
+#define ZB_ZCL_ATTR_APP_METRICS_SAADC_WORKQUEUE_US_ID  0x0201
+
+// adaptive polling: long poll interval in effect in ms, and estimates of the data polls made
+// since boot in total and at intervals shorter than the idle interval. the estimates divide
+// the time spent at each interval by the interval; the polls themselves are not counted.
+#define ZB_ZCL_ATTR_APP_METRICS_POLL_INTERVAL_MS_ID   0x0300
+#define ZB_ZCL_ATTR_APP_METRICS_POLLS_ESTIMATE_ID     0x0301
+#define ZB_ZCL_ATTR_APP_METRICS_FAST_POLLS_ESTIMATE_ID 0x0302
+
+// reliable send, commands to the coordinator's endpoint: sent, acknowledged, given up and
+// retried, and the average and longest time from the first attempt to the aps ack in ms.
+// commands sent once without waiting for their ack while every slot was in use are counted
+// apart and in none of the others.
+#define ZB_ZCL_ATTR_APP_METRICS_CMDS_SENT_ID          0x0400
+#define ZB_ZCL_ATTR_APP_METRICS_CMDS_DELIVERED_ID     0x0401
+#define ZB_ZCL_ATTR_APP_METRICS_CMDS_FAILED_ID        0x0402
+#define ZB_ZCL_ATTR_APP_METRICS_CMD_RETRIES_ID        0x0403
+#define ZB_ZCL_ATTR_APP_METRICS_DELIVERY_MS_AVG_ID    0x0404
+#define ZB_ZCL_ATTR_APP_METRICS_DELIVERY_MS_MAX_ID    0x0405
+#define ZB_ZCL_ATTR_APP_METRICS_CMDS_UNTRACKED_ID     0x0406
+
+// fast rejoin: ms from boot or from losing the network to the last join, the estimated part
+// of it with the radio on, and the rejoins on the cached channel that found the network and
+// that fell back to a rejoin over every channel
+#define ZB_ZCL_ATTR_APP_METRICS_JOIN_MS_ID            0x0500
+#define ZB_ZCL_ATTR_APP_METRICS_JOIN_RADIO_MS_ID      0x0501
+#define ZB_ZCL_ATTR_APP_METRICS_CACHED_JOINS_ID       0x0502
+#define ZB_ZCL_ATTR_APP_METRICS_CACHED_FAILURES_ID    0x0503
+
+// time the last spi flash deep power-down took in us, 0 on boards without the flash
+#define ZB_ZCL_ATTR_APP_METRICS_SPI_FLASH_POWER_DOWN_US_ID 0x0600
+
+// stack watermarks: smallest headroom left on any thread stack since boot in bytes
+#define ZB_ZCL_ATTR_APP_METRICS_STACK_MIN_UNUSED_ID   0x0700
+
+// buffer pressure: most buffer requests queued in the zboss scheduler and most buffers held
+// by the application at once, requests zboss refused, the on/off commands held back under
+// pressure that were folded into an earlier one or dropped, and the times zboss reported its
+// buffer pool low and out of memory
+#define ZB_ZCL_ATTR_APP_METRICS_BUF_WAITING_MAX_ID    0x0800
+#define ZB_ZCL_ATTR_APP_METRICS_BUF_IN_USE_MAX_ID     0x0801
+#define ZB_ZCL_ATTR_APP_METRICS_BUF_FAILURES_ID       0x0802
+#define ZB_ZCL_ATTR_APP_METRICS_CMDS_COALESCED_ID     0x0803
+#define ZB_ZCL_ATTR_APP_METRICS_CMDS_DROPPED_ID       0x0804
+#define ZB_ZCL_ATTR_APP_METRICS_BUF_MEMORY_LOW_ID     0x0805
+#define ZB_ZCL_ATTR_APP_METRICS_BUF_OOM_ID            0x0806
+
+// ota upgrade, the last download: size of the image, bytes received, ms from the start to the
+// last block and the throughput in bytes per second
+#define ZB_ZCL_ATTR_APP_METRICS_OTA_IMAGE_BYTES_ID    0x0900
+#define ZB_ZCL_ATTR_APP_METRICS_OTA_BYTES_ID          0x0901
+#define ZB_ZCL_ATTR_APP_METRICS_OTA_TRANSFER_MS_ID    0x0902
+#define ZB_ZCL_ATTR_APP_METRICS_OTA_BYTES_PER_S_ID    0x0903
+
+// button events lost because the ring from the gpio interrupt to the zboss thread was full
+#define ZB_ZCL_ATTR_APP_METRICS_BUTTON_OVERFLOWS_ID   0x0A00
+
+// attribute storage for the metrics cluster
+struct zb_zcl_app_metrics_attrs {
+#ifdef CONFIG_APP_LATENCY_PROBES
+	zb_uint8_t latency[LATENCY_STAGE_COUNT][LATENCY_ATTR_SIZE];
+#endif
+#ifdef CONFIG_APP_ENERGY_ACCOUNTING
+	zb_uint32_t energy_events[ENERGY_EVENT_COUNT];
+	zb_uint32_t led_on_time_ms;
+	zb_uint32_t consumed_uah;
+#endif
+	zb_uint32_t saadc_conversion_us;
+	zb_uint32_t saadc_workqueue_us;
+	zb_uint32_t poll_interval_ms;
+	zb_uint32_t polls_estimate;
+	zb_uint32_t fast_polls_estimate;
+	zb_uint32_t spi_flash_power_down_us;
+	zb_uint32_t button_overflows;
+#ifdef CONFIG_APP_RELIABLE_SEND
+	zb_uint32_t cmds_sent;
+	zb_uint32_t cmds_delivered;
+	zb_uint32_t cmds_failed;
+	zb_uint32_t cmd_retries;
+	zb_uint32_t delivery_ms_avg;
+	zb_uint32_t delivery_ms_max;
+	zb_uint32_t cmds_untracked;
+#endif
+#ifdef CONFIG_APP_FAST_REJOIN
+	zb_uint32_t join_ms;
+	zb_uint32_t join_radio_ms;
+	zb_uint32_t cached_joins;
+	zb_uint32_t cached_failures;
+#endif
+#ifdef CONFIG_APP_STACK_WATERMARKS
+	zb_uint32_t stack_min_unused;
+#endif
+#ifdef CONFIG_APP_BUF_PRESSURE
+	zb_uint32_t buf_waiting_max;
+	zb_uint32_t buf_in_use_max;
+	zb_uint32_t buf_failures;
+	zb_uint32_t cmds_coalesced;
+	zb_uint32_t cmds_dropped;
+	zb_uint32_t buf_memory_low;
+	zb_uint32_t buf_oom;
+#endif
+#ifdef CONFIG_APP_OTA
+	zb_uint32_t ota_image_bytes;
+	zb_uint32_t ota_bytes;
+	zb_uint32_t ota_transfer_ms;
+	zb_uint32_t ota_bytes_per_s;
+#endif
+};
+
+typedef struct zb_zcl_app_metrics_attrs zb_zcl_app_metrics_attrs_t;
+
+// Declare a read only manufacturer specific attribute of the metrics cluster
+#define ZB_ZCL_SET_APP_METRICS_ATTR_DESC(attr_id, data_ptr, attr_type) \
+	{ (attr_id), (attr_type), ZB_ZCL_ATTR_ACCESS_READ_ONLY | ZB_ZCL_ATTR_MANUF_SPEC, \
+	  APP_MANUF_CODE, (void *)(data_ptr) },
+
+#endif // __ZB_APP_METRICS_H__
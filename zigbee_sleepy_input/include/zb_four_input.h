@@ -1,14 +1,25 @@
 #ifndef __ZB_FOUR_INPUT_H__
 #define __ZB_FOUR_INPUT_H__
 
+#include "zb_app_metrics.h"
+#include "zb_app_diagnostics.h"
+
 // TODO Dimmer Switch Device ID, Considering changing to ON/OFF Switch, 0x0000
 #define ZB_DIMMER_SWITCH_DEVICE_ID 0x0104
 
 // TODO Dimmer Switch device version
 #define ZB_DEVICE_VER_DIMMER_SWITCH 0
 
-// Four input device numer of IN (server) clusters
-#define ZB_FOUR_INPUT_IN_CLUSTER_NUM 3
+// Four input device numer of IN (server) clusters: basic, identify, power config, alarms,
+// diagnostics, and the binary input and metrics clusters when enabled. a plain number, the
+// simple descriptor type name is pasted from it.
+#if defined(CONFIG_APP_CONTACT_STATE) && defined(APP_METRICS_CLUSTER)
+#define ZB_FOUR_INPUT_IN_CLUSTER_NUM 7
+#elif defined(CONFIG_APP_CONTACT_STATE) || defined(APP_METRICS_CLUSTER)
+#define ZB_FOUR_INPUT_IN_CLUSTER_NUM 6
+#else
+#define ZB_FOUR_INPUT_IN_CLUSTER_NUM 5
+#endif
 
 // Four input device number of OUT (client) clusters
 #define ZB_FOUR_INPUT_OUT_CLUSTER_NUM 2
@@ -17,9 +28,59 @@
 #define ZB_FOUR_INPUT_CLUSTER_NUM \
 	(ZB_FOUR_INPUT_IN_CLUSTER_NUM + ZB_FOUR_INPUT_OUT_CLUSTER_NUM)
 
+// Alarms cluster server the battery alarms are sent from. no alarm table is kept, so the
+// cluster revision is its only attribute; nothing to initialize unless the stack brings its
+// own handling of the reset alarm commands.
+#define ZB_ZCL_APP_ALARMS_CLUSTER_REVISION_DEFAULT ((zb_uint16_t)0x0001u)
+
+#ifndef ZB_ZCL_CLUSTER_ID_ALARMS_SERVER_ROLE_INIT
+#define ZB_ZCL_CLUSTER_ID_ALARMS_SERVER_ROLE_INIT (zb_zcl_cluster_init_t)NULL
+#endif
+#ifndef ZB_ZCL_CLUSTER_ID_ALARMS_CLIENT_ROLE_INIT
+#define ZB_ZCL_CLUSTER_ID_ALARMS_CLIENT_ROLE_INIT (zb_zcl_cluster_init_t)NULL
+#endif
+
 // Number of attributes for reporting on four input device
-// battery percentage remaining, battery alarm + battery voltage
+// battery percentage remaining, battery alarm + battery voltage + contact state when enabled
+#ifdef CONFIG_APP_CONTACT_STATE
+#define ZB_FOUR_INPUT_REPORT_ATTR_COUNT (ZB_ZCL_POWER_CONFIG_REPORT_ATTR_COUNT + 2)
+#else
 #define ZB_FOUR_INPUT_REPORT_ATTR_COUNT (ZB_ZCL_POWER_CONFIG_REPORT_ATTR_COUNT + 1)
+#endif
+
+
+// Binary input cluster descriptor and simple descriptor entry, empty when the cluster is disabled
+#ifdef CONFIG_APP_CONTACT_STATE
+#define ZB_FOUR_INPUT_BINARY_INPUT_CLUSTER_DESC(binary_input_server_attr_list) \
+	ZB_ZCL_CLUSTER_DESC(							  \
+		ZB_ZCL_CLUSTER_ID_BINARY_INPUT,				  \
+		ZB_ZCL_ARRAY_SIZE(binary_input_server_attr_list, zb_zcl_attr_t), \
+		(binary_input_server_attr_list),			  \
+		ZB_ZCL_CLUSTER_SERVER_ROLE,					  \
+		ZB_ZCL_MANUF_CODE_INVALID					  \
+	),
+#define ZB_FOUR_INPUT_BINARY_INPUT_CLUSTER_ID ZB_ZCL_CLUSTER_ID_BINARY_INPUT,
+#else
+#define ZB_FOUR_INPUT_BINARY_INPUT_CLUSTER_DESC(binary_input_server_attr_list)
+#define ZB_FOUR_INPUT_BINARY_INPUT_CLUSTER_ID
+#endif
+
+
+// Metrics cluster descriptor and simple descriptor entry, empty when the cluster is disabled
+#ifdef APP_METRICS_CLUSTER
+#define ZB_FOUR_INPUT_APP_METRICS_CLUSTER_DESC(app_metrics_server_attr_list) \
+	ZB_ZCL_CLUSTER_DESC(							  \
+		ZB_ZCL_CLUSTER_ID_APP_METRICS,				  \
+		ZB_ZCL_ARRAY_SIZE(app_metrics_server_attr_list, zb_zcl_attr_t), \
+		(app_metrics_server_attr_list),				  \
+		ZB_ZCL_CLUSTER_SERVER_ROLE,					  \
+		APP_MANUF_CODE								  \
+	),
+#define ZB_FOUR_INPUT_APP_METRICS_CLUSTER_ID ZB_ZCL_CLUSTER_ID_APP_METRICS,
+#else
+#define ZB_FOUR_INPUT_APP_METRICS_CLUSTER_DESC(app_metrics_server_attr_list)
+#define ZB_FOUR_INPUT_APP_METRICS_CLUSTER_ID
+#endif
 
 
 // Declare cluster list for four input device
@@ -30,6 +91,10 @@
 // identify_client_attr_list - attribute list for Identify cluster (client role)
 // on_off_client_attr_list - attribute list for On/Off cluster (client role)
 // power_config_server_attr_list - attribute list for Power COnfig cluster (server role)
+// alarms_server_attr_list - attribute list for Alarms cluster (server role)
+// diagnostics_server_attr_list - attribute list for Diagnostics cluster (server role)
+// binary_input_server_attr_list - attribute list for Binary Input cluster (server role), unused when disabled
+// app_metrics_server_attr_list - attribute list for the metrics cluster (server role), unused when disabled
 
 #define ZB_DECLARE_FOUR_INPUT_CLUSTER_LIST(			  \
 		cluster_list_name,						      \
@@ -37,7 +102,11 @@
 		identify_client_attr_list,					  \
 		identify_server_attr_list,					  \
 		on_off_client_attr_list,                      \
-		power_config_server_attr_list)		     	  \
+		power_config_server_attr_list,			      \
+		alarms_server_attr_list,				      \
+		diagnostics_server_attr_list,			      \
+		binary_input_server_attr_list,			      \
+		app_metrics_server_attr_list)		     	  \
 zb_zcl_cluster_desc_t cluster_list_name[] =			  \
 {										  			  \
 	ZB_ZCL_CLUSTER_DESC(							  \
@@ -61,6 +130,22 @@ zb_zcl_cluster_desc_t cluster_list_name[] =			  \
 		ZB_ZCL_CLUSTER_SERVER_ROLE,					  \
 		ZB_ZCL_MANUF_CODE_INVALID					  \
 	),									              \
+	ZB_ZCL_CLUSTER_DESC(							  \
+		ZB_ZCL_CLUSTER_ID_ALARMS,					  \
+		ZB_ZCL_ARRAY_SIZE(alarms_server_attr_list, zb_zcl_attr_t), \
+		(alarms_server_attr_list),					  \
+		ZB_ZCL_CLUSTER_SERVER_ROLE,					  \
+		ZB_ZCL_MANUF_CODE_INVALID					  \
+	),									              \
+	ZB_ZCL_CLUSTER_DESC(							  \
+		ZB_ZCL_CLUSTER_ID_DIAGNOSTICS,				  \
+		ZB_ZCL_ARRAY_SIZE(diagnostics_server_attr_list, zb_zcl_attr_t), \
+		(diagnostics_server_attr_list),				  \
+		ZB_ZCL_CLUSTER_SERVER_ROLE,					  \
+		ZB_ZCL_MANUF_CODE_INVALID					  \
+	),									              \
+	ZB_FOUR_INPUT_BINARY_INPUT_CLUSTER_DESC(binary_input_server_attr_list) \
+	ZB_FOUR_INPUT_APP_METRICS_CLUSTER_DESC(app_metrics_server_attr_list) \
 	ZB_ZCL_CLUSTER_DESC(							  \
 		ZB_ZCL_CLUSTER_ID_IDENTIFY,					  \
 		ZB_ZCL_ARRAY_SIZE(identify_client_attr_list, zb_zcl_attr_t), \
@@ -101,6 +186,10 @@ zb_zcl_cluster_desc_t cluster_list_name[] =			  \
 			ZB_ZCL_CLUSTER_ID_BASIC,				\
 			ZB_ZCL_CLUSTER_ID_IDENTIFY,				\
 			ZB_ZCL_CLUSTER_ID_POWER_CONFIG,         \
+			ZB_ZCL_CLUSTER_ID_ALARMS,               \
+			ZB_ZCL_CLUSTER_ID_DIAGNOSTICS,          \
+			ZB_FOUR_INPUT_BINARY_INPUT_CLUSTER_ID   \
+			ZB_FOUR_INPUT_APP_METRICS_CLUSTER_ID    \
 			ZB_ZCL_CLUSTER_ID_IDENTIFY,				\
 			ZB_ZCL_CLUSTER_ID_ON_OFF,				\
 		}								            \
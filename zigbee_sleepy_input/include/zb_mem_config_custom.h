@@ -33,6 +33,7 @@
  * Now if you REALLY know what you do, you can study zb_mem_config_common.h
  * and redefine some configuration parameters, like:
  */
+#ifndef CONFIG_APP_ULTRA_LOW_RAM
 #undef ZB_CONFIG_SCHEDULER_Q_SIZE
 #define ZB_CONFIG_SCHEDULER_Q_SIZE 24
 
@@ -42,6 +43,7 @@
  */
 #undef ZB_CONFIG_APS_DUPS_TABLE_SIZE
 #define ZB_CONFIG_APS_DUPS_TABLE_SIZE 64
+#endif /* CONFIG_APP_ULTRA_LOW_RAM */
 
 /* Memory context definitions. */
 #include "zb_mem_config_context.h"
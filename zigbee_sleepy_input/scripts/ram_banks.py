@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+#
+# Report the RAM used per section of zephyr.elf and how many nRF52840 RAM sections stay
+# powered after power_down_unused_ram (), which powers down every RAM section above the end
+# of the image.
+#
+# usage: ram_banks.py build/zephyr/zephyr.elf
+#
+
+import struct
+import sys
+
+RAM_START           = 0x20000000
+RAM_SIZE            = 0x40000
+
+# System ON sleep current with all 256 KB retained minus with none, nRF52840 PS v1.1
+RETENTION_NA_PER_KB = (3160 - 1500) / 256
+
+
+#----------------------------------------------------------------------------------------------
+# nRF52840 ram layout: banks 0 to 7 have two 4 KB sections, bank 8 six 32 KB sections
+#
+
+def ram_sections ():
+  sections = []
+  addr = RAM_START
+  for bank in range (8):
+    for section in range (2):
+      sections.append ((bank, section, addr, 0x1000))
+      addr += 0x1000
+  for section in range (6):
+    sections.append ((8, section, addr, 0x8000))
+    addr += 0x8000
+  return sections
+
+
+#----------------------------------------------------------------------------------------------
+# minimal 32-bit little endian elf reader: allocated sections and one symbol
+#
+
+def read_elf (path):
+  with open (path, 'rb') as f:
+    data = f.read ()
+
+  if data[:4] != b'\x7fELF' or data[4] != 1 or data[5] != 1:
+    sys.exit ("%s: not a 32-bit little endian elf file" % path)
+
+  shoff, = struct.unpack_from ('<I', data, 0x20)
+  shentsize, shnum, shstrndx = struct.unpack_from ('<HHH', data, 0x2e)
+
+  headers = []
+  for i in range (shnum):
+    headers.append (struct.unpack_from ('<IIIIIIIIII', data, shoff + i * shentsize))
+
+  def string (table, offset):
+    start = headers[table][4] + offset
+    return data[start:data.index (b'\0', start)].decode ()
+
+  sections = []
+  symbols = {}
+  for name, sh_type, flags, addr, offset, size, link, info, align, entsize in headers:
+    # SHF_ALLOC
+    if flags & 0x2:
+      sections.append ((string (shstrndx, name), addr, size))
+    # SHT_SYMTAB
+    if sh_type == 2:
+      for i in range (size // 16):
+        st_name, st_value = struct.unpack_from ('<II', data, offset + i * 16)
+        if st_name:
+          symbols[string (link, st_name)] = st_value
+
+  return sections, symbols
+
+
+#----------------------------------------------------------------------------------------------
+# main
+#
+
+def main ():
+  if len (sys.argv) != 2:
+    sys.exit ("usage: %s zephyr.elf" % sys.argv[0])
+
+  sections, symbols = read_elf (sys.argv[1])
+  in_ram = [s for s in sections if RAM_START <= s[1] < RAM_START + RAM_SIZE and s[2] > 0]
+  in_ram.sort (key=lambda s: s[1])
+
+  print ("%-24s %10s %8s" % ("section", "address", "bytes"))
+  for name, addr, size in in_ram:
+    print ("%-24s 0x%08x %8d" % (name, addr, size))
+  used = sum (s[2] for s in in_ram)
+  print ("%-24s %10s %8d" % ("total", "", used))
+
+  ram_end = symbols.get ('_image_ram_end', max ((s[1] + s[2] for s in in_ram), default=RAM_START))
+  print ("\nimage ends at 0x%08x, %d bytes into ram" % (ram_end, ram_end - RAM_START))
+
+  retained = [s for s in ram_sections () if s[2] < ram_end]
+  banks = sorted (set (s[0] for s in retained))
+  retained_kb = sum (s[3] for s in retained) // 1024
+
+  print ("retained: %d of 22 ram sections, %d KB in banks %s" %
+         (len (retained), retained_kb, ", ".join (str (b) for b in banks)))
+  print ("estimated retention current: %.2f uA" % (retained_kb * RETENTION_NA_PER_KB / 1000))
+
+
+if __name__ == '__main__':
+  main ()
@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+#
+# Convert the binary trace the device writes to its trace rtt channel (CONFIG_APP_TRACE) into
+# a chrome trace event json file, which Perfetto (ui.perfetto.dev) and chrome://tracing open.
+# The record layout and the names of the callbacks and frames come from include/trace.h.
+#
+# capture with the J-Link tools, then convert:
+#   JLinkRTTLogger -Device NRF52840_XXAA -If SWD -Speed 4000 -RTTChannel 2 trace.bin
+#   trace_decode.py trace.bin trace.json
+#
+# or capture for a number of seconds and convert in one go:
+#   trace_decode.py --capture 60 trace.bin trace.json
+#
+
+import argparse
+import json
+import os
+import re
+import struct
+import subprocess
+import sys
+import time
+
+RECORD              = struct.Struct ('<IBBH')
+TRACE_H             = os.path.join (os.path.dirname (os.path.abspath (__file__)), '..', 'include', 'trace.h')
+
+# zboss signal ids the application sees
+SIGNALS = {
+  0:  'default start',
+  1:  'skip startup',
+  2:  'device annce',
+  3:  'leave',
+  4:  'error',
+  5:  'device first start',
+  6:  'device reboot',
+  10: 'steering',
+  11: 'formation',
+  12: 'finding and binding target finished',
+  13: 'finding and binding initiator finished',
+  20: 'no active links left',
+  22: 'can sleep',
+  23: 'production config ready',
+  25: 'nlme status indication',
+}
+
+# chrome trace threads
+TID_ZBOSS           = 1
+TID_GPIO            = 2
+TID_RADIO           = 3
+
+
+#----------------------------------------------------------------------------------------------
+# enums of trace.h, as lists of lower case names without the common prefix
+#
+
+def read_enums (path):
+  with open (path) as f:
+    text = f.read ()
+
+  enums = {}
+  for name, body in re.findall (r'enum\s+(\w+)\s*\{(.*?)\}', text, re.S):
+    values = re.findall (r'^\s*([A-Z_][A-Z0-9_]*)\s*,', body, re.M)
+    prefix = os.path.commonprefix (values) if len (values) > 1 else ''
+    prefix = prefix[:prefix.rfind ('_') + 1]
+    enums[name] = [v[len (prefix):].lower () for v in values]
+  return enums
+
+
+def enum_name (names, value):
+  return names[value] if value < len (names) else str (value)
+
+
+#----------------------------------------------------------------------------------------------
+# records to trace events
+#
+
+def decode (data, enums):
+  types = enums['trace_type']
+  callbacks = enums['trace_cb']
+  frames = enums['trace_tx']
+
+  events = [
+    {'name': 'thread_name', 'ph': 'M', 'pid': 1, 'tid': TID_ZBOSS, 'args': {'name': 'zboss'}},
+    {'name': 'thread_name', 'ph': 'M', 'pid': 1, 'tid': TID_GPIO, 'args': {'name': 'gpio'}},
+    {'name': 'thread_name', 'ph': 'M', 'pid': 1, 'tid': TID_RADIO, 'args': {'name': 'radio'}},
+  ]
+
+  hz = None
+  last = None
+  cycles = 0
+  state = 0
+  pending = {}
+  tx_id = 0
+  skipped = 0
+
+  for offset in range (0, len (data) - RECORD.size + 1, RECORD.size):
+    raw, rtype, rid, arg = RECORD.unpack_from (data, offset)
+    kind = enum_name (types, rtype)
+
+    # each flush starts with the clock rate; drop what came before the first one
+    if kind == 'clock':
+      hz = raw
+      continue
+    if hz is None:
+      skipped += 1
+      continue
+
+    # 32-bit cycle counter, unwrapped into a running count
+    cycles += 0 if last is None else (raw - last) & 0xffffffff
+    last = raw
+    ts = cycles * 1e6 / hz
+
+    event = {'ts': ts, 'pid': 1, 'tid': TID_ZBOSS}
+
+    if kind == 'enter' or kind == 'exit':
+      event.update (name=enum_name (callbacks, rid), ph='B' if kind == 'enter' else 'E')
+    elif kind == 'signal':
+      event.update (name=SIGNALS.get (arg, 'signal %d' % arg), ph='i', s='t')
+    elif kind == 'lost':
+      event.update (name='lost %d records' % arg, ph='i', s='g')
+    elif kind == 'edge':
+      event.update (name='edge', ph='i', s='t', tid=TID_GPIO, args={'inputs': '0x%04x' % arg})
+    elif kind == 'settled':
+      # one counter per input that changed
+      changed = state ^ arg
+      state = arg
+      for bit in range (16):
+        if changed & (1 << bit):
+          events.append ({'name': 'input %d' % bit, 'ph': 'C', 'ts': ts, 'pid': 1,
+                          'args': {'level': (arg >> bit) & 1}})
+      continue
+    elif kind == 'tx':
+      frame = enum_name (frames, rid)
+      pending.setdefault (rid, []).append ((ts, arg))
+      event.update (name='%s 0x%04x' % (frame, arg), ph='i', s='t', tid=TID_RADIO)
+    elif kind == 'tx_done':
+      # confirms come back in the order the frames went out; the slice spans send to confirm
+      if not pending.get (rid):
+        continue
+      sent_ts, sent_arg = pending[rid].pop (0)
+      name = '%s 0x%04x' % (enum_name (frames, rid), sent_arg)
+      tx_id += 1
+      events.append ({'name': name, 'cat': 'tx', 'ph': 'b', 'id': tx_id, 'ts': sent_ts, 'pid': 1,
+                      'tid': TID_RADIO})
+      event.update (name=name, cat='tx', ph='e', id=tx_id, tid=TID_RADIO,
+                    args={'status': arg - 0x10000 if arg & 0x8000 else arg})
+    else:
+      event.update (name=kind, ph='i', s='t', args={'id': rid, 'arg': arg})
+
+    events.append (event)
+
+  if skipped:
+    print ("skipped %d records before the first clock record" % skipped, file=sys.stderr)
+
+  return events
+
+
+#----------------------------------------------------------------------------------------------
+# capture with JLinkRTTLogger, which runs until it reads a line from stdin
+#
+
+def capture (path, seconds, channel, device):
+  logger = subprocess.Popen (['JLinkRTTLogger', '-Device', device, '-If', 'SWD', '-Speed', '4000',
+                              '-RTTChannel', str (channel), path],
+                             stdin=subprocess.PIPE, stdout=subprocess.DEVNULL)
+  try:
+    time.sleep (seconds)
+  finally:
+    logger.communicate (b'\n')
+
+
+#----------------------------------------------------------------------------------------------
+# main
+#
+
+def main ():
+  parser = argparse.ArgumentParser (description="decode the trace rtt channel into a chrome trace")
+  parser.add_argument ('capture_file', help="binary records read from the rtt channel")
+  parser.add_argument ('json_file', help="chrome trace event json to write")
+  parser.add_argument ('--capture', type=float, metavar='SECONDS',
+                       help="first capture this long with JLinkRTTLogger into capture_file")
+  parser.add_argument ('--channel', type=int, default=2, help="rtt channel, CONFIG_APP_TRACE_RTT_CHANNEL")
+  parser.add_argument ('--device', default='NRF52840_XXAA', help="J-Link device name")
+  parser.add_argument ('--header', default=TRACE_H, help="trace.h the firmware was built with")
+  args = parser.parse_args ()
+
+  if args.capture:
+    capture (args.capture_file, args.capture, args.channel, args.device)
+
+  with open (args.capture_file, 'rb') as f:
+    data = f.read ()
+
+  events = decode (data, read_enums (args.header))
+
+  with open (args.json_file, 'w') as f:
+    json.dump ({'traceEvents': events, 'displayTimeUnit': 'ms'}, f)
+
+  print ("%d records, %d trace events" % (len (data) // RECORD.size, len (events)))
+
+
+if __name__ == '__main__':
+  main ()
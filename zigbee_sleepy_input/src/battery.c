@@ -0,0 +1,199 @@
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/irq.h>
+#include <zephyr/sys/util.h>
+#include <errno.h>
+
+#include <drivers/include/nrfx_saadc.h>
+
+#include <zboss_api.h>
+#include <zb_nrf_platform.h>
+
+#include "battery.h"
+#include "battery_curves.h"
+
+#define SAADC_NODE DT_NODELABEL(adc)
+
+// the driver enables the interrupt at the priority it was connected with
+#if DT_NODE_EXISTS(SAADC_NODE)
+#define SAADC_IRQ_PRIORITY DT_IRQ(SAADC_NODE, priority)
+#else
+#define SAADC_IRQ_PRIORITY 0
+#endif
+
+#if defined(CONFIG_APP_BATTERY_AAA_LITHIUM)
+#define BATTERY_CURVE_PREFIX BATTERY_CURVE_AAA_LITHIUM
+#elif defined(CONFIG_APP_BATTERY_LIPO)
+#define BATTERY_CURVE_PREFIX BATTERY_CURVE_LIPO
+#else
+#define BATTERY_CURVE_PREFIX BATTERY_CURVE_CR2032
+#endif
+
+// a single lipo cell reaches 4.2 V, past the 3.6 V full scale of the vdd input at gain 1/6.
+// the cell powers vddh through the regulator's high voltage mode instead, and the saadc
+// reads vddh divided by 5.
+#ifdef CONFIG_APP_BATTERY_LIPO
+#define BATTERY_INPUT         NRF_SAADC_INPUT_VDDHDIV5
+#define BATTERY_INPUT_DIVIDER 5
+#else
+#define BATTERY_INPUT         NRF_SAADC_INPUT_VDD
+#define BATTERY_INPUT_DIVIDER 1
+#endif
+
+#define BATTERY_CURVE         BATTERY_CURVE_PREFIX
+#define BATTERY_MIN_MV        UTIL_CAT(BATTERY_CURVE_PREFIX, _MIN_MV)
+#define BATTERY_MAX_MV        UTIL_CAT(BATTERY_CURVE_PREFIX, _MAX_MV)
+#define BATTERY_LUT_SIZE      UTIL_CAT(BATTERY_CURVE_PREFIX, _LUT_SIZE)
+
+BUILD_ASSERT(BATTERY_LUT_SIZE == BATTERY_MAX_MV - BATTERY_MIN_MV + 1,
+             "battery curve lut size does not match its voltage range");
+
+// capacity of the selected chemistry at every mV from BATTERY_MIN_MV to BATTERY_MAX_MV,
+// expanded by the compiler from the curve's segments
+#define BATTERY_LUT_ENTRY(i, _) BATTERY_CURVE(BATTERY_MIN_MV + (i))
+
+static const uint8_t level_lut[BATTERY_LUT_SIZE] = {
+	LISTIFY(BATTERY_LUT_SIZE, BATTERY_LUT_ENTRY, (,))
+};
+
+static void battery_saadc_handler (nrfx_saadc_evt_t const *event);
+static void battery_finish (zb_bufid_t bufid);
+
+static battery_done_t done_cb;
+static atomic_t busy;
+
+// written by easydma while the conversion runs
+static nrf_saadc_value_t sample;
+
+static uint32_t start_cycles;
+static uint32_t conversion_us;
+static uint32_t caller_us;
+
+void battery_init (void)
+{
+#if DT_NODE_EXISTS(SAADC_NODE)
+	// the nrfx driver is used directly, so route the saadc interrupt to it
+	IRQ_CONNECT (DT_IRQN(SAADC_NODE), SAADC_IRQ_PRIORITY,
+	             nrfx_isr, nrfx_saadc_irq_handler, 0);
+#endif
+}
+
+int battery_sample_start (battery_done_t done)
+{
+	uint32_t entry = k_cycle_get_32 ();
+	nrfx_saadc_channel_t channel;
+	nrfx_err_t status;
+
+	if (!atomic_cas (&busy, 0, 1)) {
+		return -EBUSY;
+	}
+
+	done_cb = done;
+
+	status = nrfx_saadc_init (SAADC_IRQ_PRIORITY);
+	if (status != NRFX_SUCCESS) {
+		atomic_clear (&busy);
+		return -EIO;
+	}
+
+	// burst mode takes all eight oversamples from a single sample task, so the conversion
+	// finishes without any further help from the cpu
+	channel.channel_config.resistor_p = NRF_SAADC_RESISTOR_DISABLED;
+	channel.channel_config.resistor_n = NRF_SAADC_RESISTOR_DISABLED;
+	channel.channel_config.gain       = NRF_SAADC_GAIN1_6;
+	channel.channel_config.reference  = NRF_SAADC_REFERENCE_INTERNAL;
+	channel.channel_config.acq_time   = NRFX_SAADC_DEFAULT_ACQTIME;
+	channel.channel_config.mode       = NRF_SAADC_MODE_SINGLE_ENDED;
+	channel.channel_config.burst      = NRF_SAADC_BURST_ENABLED;
+	channel.pin_p                     = BATTERY_INPUT;
+	channel.pin_n                     = NRF_SAADC_INPUT_DISABLED;
+	channel.channel_index             = 0;
+
+	status = nrfx_saadc_channel_config (&channel);
+
+	// a non-null event handler selects the non-blocking mode
+	if (status == NRFX_SUCCESS) {
+		status = nrfx_saadc_simple_mode_set ((1<<0),
+		                                     NRF_SAADC_RESOLUTION_14BIT,
+		                                     NRF_SAADC_OVERSAMPLE_8X,
+		                                     battery_saadc_handler);
+	}
+
+	if (status == NRFX_SUCCESS) {
+		status = nrfx_saadc_buffer_set (&sample, 1);
+	}
+
+	if (status == NRFX_SUCCESS) {
+		start_cycles = k_cycle_get_32 ();
+		status = nrfx_saadc_mode_trigger ();
+	}
+
+	if (status != NRFX_SUCCESS) {
+		nrfx_saadc_uninit ();
+		atomic_clear (&busy);
+		return -EIO;
+	}
+
+	caller_us += k_cyc_to_us_floor32 (k_cycle_get_32 () - entry);
+	return 0;
+}
+
+// saadc interrupt: the buffer is filled on DONE and the driver is idle again on FINISHED
+static void battery_saadc_handler (nrfx_saadc_evt_t const *event)
+{
+	switch (event->type) {
+	case NRFX_SAADC_EVT_DONE:
+		conversion_us = k_cyc_to_us_floor32 (k_cycle_get_32 () - start_cycles);
+		break;
+
+	case NRFX_SAADC_EVT_FINISHED:
+		if (zigbee_schedule_callback (battery_finish, 0) != RET_OK) {
+			// no room in the zboss queue; drop this reading, the next period retries
+			nrfx_saadc_uninit ();
+			atomic_clear (&busy);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+// zboss thread: power the saadc down and hand the reading to the application
+static void battery_finish (zb_bufid_t bufid)
+{
+	ZVUNUSED(bufid);
+
+	nrfx_saadc_uninit ();
+
+	// 14 bit result, gain 1/6 and 600 mV reference, times the divider ahead of the input
+	int32_t resolution = 14;
+	int32_t gainrecip = 6;
+	int32_t ref_mv = 600;
+	int32_t mv = (sample * ref_mv * gainrecip * BATTERY_INPUT_DIVIDER) >> resolution;
+
+	battery_done_t done = done_cb;
+	atomic_clear (&busy);
+
+	if (done != NULL) {
+		done (mv);
+	}
+}
+
+uint8_t battery_level_from_mv (int32_t mv)
+{
+	// the curves are flat beyond their endpoints
+	mv = CLAMP(mv, BATTERY_MIN_MV, BATTERY_MAX_MV);
+
+	return level_lut[mv - BATTERY_MIN_MV];
+}
+
+uint32_t battery_conversion_us (void)
+{
+	return conversion_us;
+}
+
+uint32_t battery_caller_us (void)
+{
+	return caller_us;
+}
@@ -0,0 +1,113 @@
+#include <zephyr/kernel.h>
+
+#include <zboss_api.h>
+
+#include "battery_alarm.h"
+#include "reporting.h"
+#include "energy.h"
+#include "buf_pressure.h"
+#include "trace.h"
+
+// the min threshold and thresholds 1-3, each with a bit in the alarm mask and alarm state
+// and an alarm code, for battery source 1
+#define BATTERY_ALARM_COUNT        4
+#define BATTERY_ALARM_CODE(i)      (0x10 + (i))
+
+// a raised alarm clears once the battery is this far above its thresholds again, so a
+// voltage sitting on a threshold does not raise it over and over
+#define VOLTAGE_HYSTERESIS         1        // 100 mV
+#define PERCENT_HYSTERESIS         (2*2)    // 2 %
+
+static void battery_alarm_send (zb_bufid_t bufid, zb_uint16_t alarm_code);
+
+static const zb_uint16_t voltage_threshold_ids[BATTERY_ALARM_COUNT] = {
+	ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_MIN_THRESHOLD_ID,
+	ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_THRESHOLD1_ID,
+	ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_THRESHOLD2_ID,
+	ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_THRESHOLD3_ID,
+};
+
+static const zb_uint16_t percent_threshold_ids[BATTERY_ALARM_COUNT] = {
+	ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_MIN_THRESHOLD_ID,
+	ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_THRESHOLD1_ID,
+	ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_THRESHOLD2_ID,
+	ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_THRESHOLD3_ID,
+};
+
+static zb_uint8_t src_ep;
+static zb_uint16_t dst_addr;
+static zb_uint8_t dst_ep;
+
+void battery_alarm_init (zb_uint8_t ep, zb_uint16_t addr, zb_uint8_t endpoint)
+{
+	src_ep = ep;
+	dst_addr = addr;
+	dst_ep = endpoint;
+}
+
+// thresholds and the mask are writable by the coordinator, so read them from the
+// attribute storage on every evaluation
+static void *battery_alarm_attr (zb_uint16_t attr_id)
+{
+	zb_zcl_attr_t *desc = zb_zcl_get_attr_desc_a (src_ep, ZB_ZCL_CLUSTER_ID_POWER_CONFIG,
+	                                              ZB_ZCL_CLUSTER_SERVER_ROLE, attr_id);
+
+	return (desc != NULL) ? desc->data_p : NULL;
+}
+
+static zb_uint8_t battery_alarm_u8 (zb_uint16_t attr_id)
+{
+	zb_uint8_t *value = battery_alarm_attr (attr_id);
+
+	return (value != NULL) ? *value : 0;
+}
+
+void battery_alarm_update (zb_uint8_t voltage, zb_uint8_t percent)
+{
+	zb_uint32_t *state_attr = battery_alarm_attr (ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_ALARM_STATE_ID);
+	zb_uint32_t old_state = (state_attr != NULL) ? *state_attr : 0;
+	zb_uint32_t state = old_state;
+
+	for (int i = 0; i < BATTERY_ALARM_COUNT; i++) {
+		zb_uint8_t voltage_threshold = battery_alarm_u8 (voltage_threshold_ids[i]);
+		zb_uint8_t percent_threshold = battery_alarm_u8 (percent_threshold_ids[i]);
+
+		// a threshold of 0 is not in use
+		bool reached = ((voltage_threshold != 0) && (voltage <= voltage_threshold)) ||
+		               ((percent_threshold != 0) && (percent <= percent_threshold));
+		bool recovered = ((voltage_threshold == 0) || (voltage >= voltage_threshold + VOLTAGE_HYSTERESIS)) &&
+		                 ((percent_threshold == 0) || (percent >= percent_threshold + PERCENT_HYSTERESIS));
+
+		if (reached) {
+			state |= BIT(i);
+		} else if (recovered) {
+			state &= ~BIT(i);
+		}
+	}
+
+	if (state == old_state) {
+		return;
+	}
+
+	// reported together with the sample that changed it
+	reporting_set (ZB_ZCL_CLUSTER_ID_POWER_CONFIG, ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_ALARM_STATE_ID,
+	               &state);
+
+	zb_uint32_t raised = state & ~old_state & battery_alarm_u8 (ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_ALARM_MASK_ID);
+
+	for (int i = 0; i < BATTERY_ALARM_COUNT; i++) {
+		if (raised & BIT(i)) {
+			buf_pressure_get (battery_alarm_send, BATTERY_ALARM_CODE(i));
+		}
+	}
+}
+
+static void battery_alarm_send (zb_bufid_t bufid, zb_uint16_t alarm_code)
+{
+	buf_pressure_granted ();
+	trace_record (TRACE_TX, TRACE_TX_ALARM, alarm_code);
+	ZB_ZCL_ALARMS_SEND_ALARM_RES(bufid, dst_addr, ZB_APS_ADDR_MODE_16_ENDP_PRESENT, dst_ep, src_ep,
+	                             ZB_AF_HA_PROFILE_ID, NULL, alarm_code, ZB_ZCL_CLUSTER_ID_POWER_CONFIG);
+	energy_count (ENERGY_EVENT_TX);
+	buf_pressure_freed ();
+}
@@ -0,0 +1,212 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include <zboss_api.h>
+
+#include "buf_pressure.h"
+
+#define LIMIT               CONFIG_APP_BUF_PRESSURE_LIMIT
+#define HOLD_SIZE           CONFIG_APP_BUF_PRESSURE_HOLD_SIZE
+
+// retry of held commands while no buffer is outstanding to bring them back
+#define RETRY_MS            100
+
+struct held_cmd {
+	uint32_t edge_cycles;       // k_cycle_get_32 () timestamp of the first edge it stands for
+	zb_uint16_t cmd_id;
+	zb_uint8_t input;
+};
+
+static void buf_pressure_flush (zb_uint8_t param);
+
+static buf_pressure_send_t send_cb;
+static struct buf_pressure_stats stats;
+static uint32_t waiting;            // requested, callback not run yet
+static uint32_t in_use;             // granted, not freed yet
+static bool refused;                // zboss refused the last request
+static bool memory_low;             // zboss reported its pool low at the last sample
+static bool oom;                    // zboss reported its pool exhausted at the last sample
+
+// held commands, oldest at head
+static struct held_cmd held[HOLD_SIZE];
+static size_t head;
+static size_t count;
+
+void buf_pressure_init (buf_pressure_send_t send)
+{
+	send_cb = send;
+}
+
+// sample the stack's own view of its buffer pool, counting the times it went low or out of
+// memory
+static void buf_pressure_sample (void)
+{
+	bool low = zb_buf_memory_low ();
+	bool out = zb_buf_is_oom_state ();
+
+	if (low && !memory_low) {
+		stats.memory_low++;
+	}
+	if (out && !oom) {
+		stats.oom++;
+	}
+
+	memory_low = low;
+	oom = out;
+}
+
+zb_ret_t buf_pressure_get (zb_callback2_t func, zb_uint16_t param)
+{
+	buf_pressure_sample ();
+
+	zb_ret_t ret = zb_buf_get_out_delayed_ext (func, param, 0);
+
+	if (ret != RET_OK) {
+		stats.failures++;
+		refused = true;
+		return ret;
+	}
+
+	waiting++;
+	stats.waiting_max = MAX(stats.waiting_max, waiting);
+	return RET_OK;
+}
+
+void buf_pressure_granted (void)
+{
+	if (waiting > 0) {
+		waiting--;
+	}
+
+	in_use++;
+	stats.in_use_max = MAX(stats.in_use_max, in_use);
+	buf_pressure_sample ();
+}
+
+void buf_pressure_freed (void)
+{
+	if (in_use > 0) {
+		in_use--;
+	}
+
+	refused = false;
+	buf_pressure_flush (0);
+}
+
+bool buf_pressure_high (void)
+{
+	buf_pressure_sample ();
+	return refused || memory_low || oom || ((waiting + in_use) >= LIMIT);
+}
+
+// nothing outstanding will come back and flush the held commands, so try again later
+static void buf_pressure_retry_later (void)
+{
+	if ((count > 0) && (waiting == 0) && (in_use == 0)) {
+		ZB_SCHEDULE_APP_ALARM_CANCEL (buf_pressure_flush, ZB_ALARM_ANY_PARAM);
+		ZB_SCHEDULE_APP_ALARM (buf_pressure_flush, 0, ZB_MILLISECONDS_TO_BEACON_INTERVAL(RETRY_MS));
+	}
+}
+
+static void buf_pressure_remove (size_t i)
+{
+	for (; i + 1 < count; i++) {
+		held[(head + i) % HOLD_SIZE] = held[(head + i + 1) % HOLD_SIZE];
+	}
+	count--;
+}
+
+// fold a newer command into the held one for the same input, when sending only the result
+// leaves the light in the state both would have. returns false when both must be sent.
+static bool buf_pressure_coalesce (size_t i, zb_uint16_t cmd_id)
+{
+	struct held_cmd *cmd = &held[(head + i) % HOLD_SIZE];
+
+	if ((cmd->cmd_id != ZB_ZCL_CMD_ON_OFF_OFF_ID) && (cmd->cmd_id != ZB_ZCL_CMD_ON_OFF_ON_ID) &&
+	    (cmd->cmd_id != ZB_ZCL_CMD_ON_OFF_TOGGLE_ID)) {
+		return false;
+	}
+
+	switch (cmd_id) {
+	case ZB_ZCL_CMD_ON_OFF_OFF_ID:
+	case ZB_ZCL_CMD_ON_OFF_ON_ID:
+		cmd->cmd_id = cmd_id;
+		return true;
+
+	case ZB_ZCL_CMD_ON_OFF_TOGGLE_ID:
+		if (cmd->cmd_id == ZB_ZCL_CMD_ON_OFF_TOGGLE_ID) {
+			// two toggles cancel
+			buf_pressure_remove (i);
+		} else {
+			cmd->cmd_id = (cmd->cmd_id == ZB_ZCL_CMD_ON_OFF_ON_ID) ?
+			              ZB_ZCL_CMD_ON_OFF_OFF_ID : ZB_ZCL_CMD_ON_OFF_ON_ID;
+		}
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+bool buf_pressure_hold (zb_uint8_t input, zb_uint16_t cmd_id, uint32_t edge_cycles)
+{
+	if ((count == 0) && !buf_pressure_high ()) {
+		return false;
+	}
+
+	// only the newest held command of the input, so its commands keep their order
+	for (size_t i = count; i-- > 0; ) {
+		if (held[(head + i) % HOLD_SIZE].input != input) {
+			continue;
+		}
+		if (buf_pressure_coalesce (i, cmd_id)) {
+			stats.coalesced++;
+			buf_pressure_retry_later ();
+			return true;
+		}
+		break;
+	}
+
+	if (count == HOLD_SIZE) {
+		head = (head + 1) % HOLD_SIZE;
+		count--;
+		stats.dropped++;
+	}
+
+	struct held_cmd *cmd = &held[(head + count) % HOLD_SIZE];
+	cmd->edge_cycles = edge_cycles;
+	cmd->cmd_id = cmd_id;
+	cmd->input = input;
+	count++;
+
+	buf_pressure_retry_later ();
+	return true;
+}
+
+// send held commands oldest first until the pressure is high again
+static void buf_pressure_flush (zb_uint8_t param)
+{
+	ZVUNUSED(param);
+
+	if ((waiting == 0) && (in_use == 0)) {
+		refused = false;
+	}
+
+	while ((count > 0) && !buf_pressure_high ()) {
+		struct held_cmd *cmd = &held[head];
+
+		if (send_cb (cmd->input, cmd->cmd_id, cmd->edge_cycles) != RET_OK) {
+			break;
+		}
+
+		head = (head + 1) % HOLD_SIZE;
+		count--;
+	}
+
+	buf_pressure_retry_later ();
+}
+
+const struct buf_pressure_stats *buf_pressure_stats (void)
+{
+	return &stats;
+}
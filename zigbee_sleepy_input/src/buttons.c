@@ -0,0 +1,241 @@
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/gpio.h>
+
+#include <zboss_api.h>
+#include <zb_nrf_platform.h>
+
+#include "buttons.h"
+#include "debounce.h"
+#include "latency.h"
+#include "trace.h"
+
+#define BUTTONS_NODE DT_PATH(buttons)
+
+#define GPIO_SPEC_AND_COMMA(button_or_led) GPIO_DT_SPEC_GET(button_or_led, gpios),
+
+// number of events the gpio interrupt can queue before the zboss thread drains them.
+// must be a power of two.
+#define BUTTONS_RING_SIZE 16
+#define BUTTONS_RING_MASK (BUTTONS_RING_SIZE - 1)
+
+BUILD_ASSERT((BUTTONS_RING_SIZE & BUTTONS_RING_MASK) == 0, "BUTTONS_RING_SIZE must be a power of two");
+
+// one debounced input change captured in interrupt context
+struct buttons_event {
+	uint32_t changed;   // inputs that changed since the previous event
+	uint32_t state;     // state of all inputs after the change
+	uint32_t cycles;    // hardware cycle counter at the first edge of the change
+#ifdef CONFIG_APP_LATENCY_PROBES
+	uint32_t queued;    // hardware cycle counter when the settled change was queued
+#endif
+};
+
+static const struct gpio_dt_spec buttons[] = {
+#if DT_NODE_EXISTS(BUTTONS_NODE)
+	DT_FOREACH_CHILD(BUTTONS_NODE, GPIO_SPEC_AND_COMMA)
+#endif
+};
+
+static uint32_t buttons_read (void);
+static void buttons_changed (const struct device *gpio_dev, struct gpio_callback *cb, uint32_t pins);
+static void buttons_queue_event (uint32_t state, uint32_t cycles);
+static void buttons_drain (zb_bufid_t bufid);
+
+static button_handler_t button_handler_cb;
+
+// a callback can only be on one port's list, so there is one per port, with its own pins
+static struct gpio_callback gpio_cbs[ARRAY_SIZE(buttons)];
+static const struct device *gpio_cb_ports[ARRAY_SIZE(buttons)];
+static size_t gpio_cb_count;
+static atomic_t buttons_state;
+
+// single producer (debounce timer interrupt), single consumer (zboss thread) event ring.
+// the producer only writes ring_head and the consumer only writes ring_tail.
+static struct buttons_event ring[BUTTONS_RING_SIZE];
+static atomic_t ring_head;
+static atomic_t ring_tail;
+static atomic_t ring_overflows;
+static atomic_t drain_scheduled;
+
+// timestamp of the event currently being passed to the button handler
+static uint32_t current_event_cycles;
+
+void buttons_init (button_handler_t button_handler)
+{
+    int err;
+
+    printk (">>> buttons init\n");
+
+    button_handler_cb = button_handler;
+
+    for (size_t i = 0; i < ARRAY_SIZE(buttons); i++) {
+        printk ("initializing button %zu\n", i);
+
+        err = gpio_pin_configure_dt(&buttons[i], GPIO_INPUT);
+        if (err) {
+			printk ("Cannot configure button gpio");
+			return;
+		}
+
+		err = gpio_pin_interrupt_configure_dt(&buttons[i], GPIO_INT_TRIG_BOTH);
+        if (err) {
+			printk ("Cannot enable trig both callback");
+			return;
+		}
+	}
+
+	gpio_port_pins_t pin_masks[ARRAY_SIZE(buttons)];
+
+	for (size_t i = 0; i < ARRAY_SIZE(buttons); i++) {
+		size_t p;
+
+		for (p = 0; p < gpio_cb_count; p++) {
+			if (gpio_cb_ports[p] == buttons[i].port) {
+				break;
+			}
+		}
+
+		if (p == gpio_cb_count) {
+			gpio_cb_ports[p] = buttons[i].port;
+			pin_masks[p] = 0;
+			gpio_cb_count++;
+		}
+		pin_masks[p] |= BIT(buttons[i].pin);
+	}
+
+	for (size_t p = 0; p < gpio_cb_count; p++) {
+		printk ("port %zu pin_mask: %08x\n", p, pin_masks[p]);
+		gpio_init_callback (&gpio_cbs[p], buttons_changed, pin_masks[p]);
+		gpio_add_callback (gpio_cb_ports[p], &gpio_cbs[p]);
+	}
+
+	atomic_set (&buttons_state, (atomic_val_t)buttons_read ());
+	debounce_init (buttons_read, buttons_queue_event, atomic_get (&buttons_state));
+
+    dk_read_buttons (NULL, NULL);
+
+    printk ("<<< buttons init\n");
+}
+
+static uint32_t buttons_read (void)
+{
+	const struct device *port = NULL;
+	gpio_port_value_t port_val = 0;
+	uint32_t ret = 0;
+
+	// read each gpio port once instead of every pin individually
+	for (size_t i = 0; i < ARRAY_SIZE(buttons); i++) {
+		if (buttons[i].port != port) {
+			port = buttons[i].port;
+			gpio_port_get (port, &port_val);
+		}
+		if (port_val & BIT(buttons[i].pin)) {
+			ret |= 1U << i;
+		}
+	}
+	return ret;
+}
+
+// gpio interrupt: restart the settle time of every input on this port that saw an edge
+static void buttons_changed (const struct device *gpio_dev, struct gpio_callback *cb, uint32_t pins)
+{
+	uint32_t inputs = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(buttons); i++) {
+		if ((buttons[i].port == gpio_dev) && (pins & BIT(buttons[i].pin))) {
+			inputs |= BIT(i);
+		}
+	}
+
+	trace_record (TRACE_EDGE, 0, inputs);
+	debounce_kick (inputs);
+}
+
+// debounce timer interrupt: capture the settled change into the ring and let the
+// zboss thread do the rest
+static void buttons_queue_event (uint32_t state, uint32_t cycles)
+{
+	uint32_t changed = (uint32_t)atomic_get (&buttons_state) ^ state;
+
+	if (changed == 0) {
+		return;
+	}
+
+	uint32_t head = atomic_get (&ring_head);
+	if ((head - (uint32_t)atomic_get (&ring_tail)) >= BUTTONS_RING_SIZE) {
+		// ring full: drop this event but keep the last queued state so the next
+		// event carries the combined change and no edge is lost from the state
+		atomic_inc (&ring_overflows);
+		return;
+	}
+
+	ring[head & BUTTONS_RING_MASK].changed = changed;
+	ring[head & BUTTONS_RING_MASK].state = state;
+	ring[head & BUTTONS_RING_MASK].cycles = cycles;
+#ifdef CONFIG_APP_LATENCY_PROBES
+	ring[head & BUTTONS_RING_MASK].queued = k_cycle_get_32 ();
+	latency_record (LATENCY_STAGE_SETTLE, cycles, ring[head & BUTTONS_RING_MASK].queued);
+#endif
+	atomic_set (&ring_head, head + 1);
+	atomic_set (&buttons_state, (atomic_val_t)state);
+	trace_record (TRACE_SETTLED, 0, state);
+
+	// only one drain callback needs to be pending at a time
+	if (atomic_cas (&drain_scheduled, 0, 1)) {
+		if (zigbee_schedule_callback (buttons_drain, 0) != RET_OK) {
+			atomic_clear (&drain_scheduled);
+		}
+	}
+}
+
+// zboss thread: pass every queued event to the application's button handler
+static void buttons_drain (zb_bufid_t bufid)
+{
+	ZVUNUSED(bufid);
+	trace_cb_enter (TRACE_CB_BUTTONS_DRAIN);
+
+	// clear first so an event queued while draining schedules another pass
+	atomic_clear (&drain_scheduled);
+
+	uint32_t tail = atomic_get (&ring_tail);
+	while (tail != (uint32_t)atomic_get (&ring_head)) {
+		struct buttons_event event = ring[tail & BUTTONS_RING_MASK];
+		atomic_set (&ring_tail, ++tail);
+
+		current_event_cycles = event.cycles;
+#ifdef CONFIG_APP_LATENCY_PROBES
+		latency_record (LATENCY_STAGE_DISPATCH, event.queued, k_cycle_get_32 ());
+#endif
+		button_handler_cb (event.state, event.changed);
+	}
+
+	trace_cb_exit (TRACE_CB_BUTTONS_DRAIN);
+}
+
+uint32_t buttons_event_cycles (void)
+{
+	return current_event_cycles;
+}
+
+uint32_t buttons_overflow_count (void)
+{
+	return (uint32_t)atomic_get (&ring_overflows);
+}
+
+void dk_read_buttons (uint32_t *button_state, uint32_t *has_changed)
+{
+	static uint32_t last_state;
+	uint32_t current_state = atomic_get(&buttons_state);
+
+	if (button_state != NULL) {
+		*button_state = current_state;
+	}
+
+	if (has_changed != NULL) {
+		*has_changed = (current_state ^ last_state);
+	}
+
+	last_state = current_state;
+}
@@ -0,0 +1,124 @@
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/math_extras.h>
+
+#include "debounce.h"
+
+#define BUTTONS_NODE DT_PATH(buttons)
+
+#define SETTLE_MS_AND_COMMA(button) DT_PROP_OR(button, settle_time_ms, CONFIG_BUTTONS_DEFAULT_SETTLE_TIME_MS),
+
+// per-input settle time from the settle-time-ms property of each gpio-keys child
+static const uint16_t settle_ms[] = {
+#if DT_NODE_EXISTS(BUTTONS_NODE)
+	DT_FOREACH_CHILD(BUTTONS_NODE, SETTLE_MS_AND_COMMA)
+#endif
+};
+
+#define DEBOUNCE_INPUTS ARRAY_SIZE(settle_ms)
+
+BUILD_ASSERT(DEBOUNCE_INPUTS <= 32, "at most 32 debounced inputs are supported");
+
+static void debounce_expiry (struct k_timer *timer);
+
+static debounce_sample_t sample_cb;
+static debounce_report_t report_cb;
+
+// one timer shared by every input, always armed for the earliest pending deadline
+static K_TIMER_DEFINE(debounce_timer, debounce_expiry, NULL);
+static struct k_spinlock lock;
+
+static uint32_t stable_state;                    // last settled state of all inputs
+static uint32_t pending;                         // inputs waiting for their settle time
+static uint32_t deadline[DEBOUNCE_INPUTS];       // k_uptime_get_32 () when each input settles
+static uint32_t first_edge[DEBOUNCE_INPUTS];     // k_cycle_get_32 () of each burst's first edge
+
+void debounce_init (debounce_sample_t sample, debounce_report_t report, uint32_t initial_state)
+{
+	sample_cb = sample;
+	report_cb = report;
+	stable_state = initial_state;
+	pending = 0;
+}
+
+// arm the shared timer for the earliest pending deadline. call with lock held.
+static void debounce_rearm (uint32_t now)
+{
+	int32_t next = INT32_MAX;
+	uint32_t inputs = pending;
+
+	while (inputs) {
+		uint32_t i = u32_count_trailing_zeros (inputs);
+		inputs &= inputs - 1;
+		next = MIN(next, (int32_t)(deadline[i] - now));
+	}
+
+	if (pending) {
+		k_timer_start (&debounce_timer, K_MSEC(MAX(next, 0)), K_NO_WAIT);
+	}
+}
+
+void debounce_kick (uint32_t inputs)
+{
+	k_spinlock_key_t key = k_spin_lock (&lock);
+	uint32_t now = k_uptime_get_32 ();
+	uint32_t cycles = k_cycle_get_32 ();
+
+	inputs &= BIT_MASK(DEBOUNCE_INPUTS);
+
+	// every edge pushes the deadline out again, so a burst of bounces settles once
+	uint32_t walk = inputs;
+	while (walk) {
+		uint32_t i = u32_count_trailing_zeros (walk);
+		walk &= walk - 1;
+		if (!(pending & BIT(i))) {
+			first_edge[i] = cycles;
+		}
+		deadline[i] = now + settle_ms[i];
+	}
+	pending |= inputs;
+
+	debounce_rearm (now);
+	k_spin_unlock (&lock, key);
+}
+
+static void debounce_expiry (struct k_timer *timer)
+{
+	k_spinlock_key_t key = k_spin_lock (&lock);
+	uint32_t now = k_uptime_get_32 ();
+	uint32_t settled = 0;
+	uint32_t cycles = 0;
+	bool have_cycles = false;
+
+	uint32_t walk = pending;
+	while (walk) {
+		uint32_t i = u32_count_trailing_zeros (walk);
+		walk &= walk - 1;
+		if ((int32_t)(deadline[i] - now) <= 0) {
+			settled |= BIT(i);
+		}
+	}
+	pending &= ~settled;
+
+	// only inputs that settled at a different level than before produce an edge
+	uint32_t changed = (sample_cb () ^ stable_state) & settled;
+	stable_state ^= changed;
+
+	walk = changed;
+	while (walk) {
+		uint32_t i = u32_count_trailing_zeros (walk);
+		walk &= walk - 1;
+		if (!have_cycles || (int32_t)(first_edge[i] - cycles) < 0) {
+			cycles = first_edge[i];
+			have_cycles = true;
+		}
+	}
+
+	uint32_t state = stable_state;
+	debounce_rearm (now);
+	k_spin_unlock (&lock, key);
+
+	if (changed) {
+		report_cb (state, cycles);
+	}
+}
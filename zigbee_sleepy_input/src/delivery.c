@@ -0,0 +1,189 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include <zboss_api.h>
+
+#include "delivery.h"
+#include "buf_pressure.h"
+#include "trace.h"
+
+#define RETRIES             CONFIG_APP_RELIABLE_SEND_RETRIES
+#define BACKOFF_MS          CONFIG_APP_RELIABLE_SEND_BACKOFF_MS
+#define BACKOFF_MAX_MS      CONFIG_APP_RELIABLE_SEND_BACKOFF_MAX_MS
+
+// commands waiting for an ack or a retry at once
+#define MAX_INFLIGHT        8
+
+// destination endpoints counters are kept for
+#define MAX_ENDPOINTS       4
+
+struct delivery_slot {
+	bool used;
+	zb_bufid_t bufid;           // buffer of the attempt in the air, ZB_BUF_INVALID otherwise
+	zb_uint16_t cmd_id;
+	zb_uint8_t dst_ep;
+	zb_uint8_t attempt;         // retries made so far
+	uint32_t start_ms;          // uptime of the first attempt
+};
+
+static void delivery_attempt (zb_bufid_t bufid, zb_uint16_t index);
+static void delivery_retry (zb_uint8_t index);
+
+static delivery_send_t send_cb;
+static struct delivery_slot slots[MAX_INFLIGHT];
+static struct delivery_stats stats[MAX_ENDPOINTS];
+static size_t stats_count;
+
+void delivery_init (delivery_send_t send)
+{
+	send_cb = send;
+
+	for (size_t i = 0; i < MAX_INFLIGHT; i++) {
+		slots[i].bufid = ZB_BUF_INVALID;
+	}
+}
+
+static struct delivery_stats *delivery_ep_stats (zb_uint8_t dst_ep, bool add)
+{
+	for (size_t i = 0; i < stats_count; i++) {
+		if (stats[i].dst_ep == dst_ep) {
+			return &stats[i];
+		}
+	}
+
+	if (!add || (stats_count == MAX_ENDPOINTS)) {
+		return NULL;
+	}
+
+	stats[stats_count].dst_ep = dst_ep;
+	return &stats[stats_count++];
+}
+
+zb_ret_t delivery_send (zb_uint8_t dst_ep, zb_uint16_t cmd_id)
+{
+	struct delivery_stats *st = delivery_ep_stats (dst_ep, true);
+	zb_ret_t ret;
+	size_t i;
+
+	for (i = 0; i < MAX_INFLIGHT; i++) {
+		if (!slots[i].used) {
+			break;
+		}
+	}
+
+	// too many commands unconfirmed; send this one without waiting for its ack
+	if (i == MAX_INFLIGHT) {
+		ret = buf_pressure_get (send_cb, cmd_id);
+		if ((ret == RET_OK) && (st != NULL)) {
+			st->untracked++;
+		}
+		return ret;
+	}
+
+	slots[i].used = true;
+	slots[i].bufid = ZB_BUF_INVALID;
+	slots[i].cmd_id = cmd_id;
+	slots[i].dst_ep = dst_ep;
+	slots[i].attempt = 0;
+	slots[i].start_ms = k_uptime_get_32 ();
+
+	ret = buf_pressure_get (delivery_attempt, i);
+	if (ret != RET_OK) {
+		slots[i].used = false;
+	} else if (st != NULL) {
+		st->sent++;
+	}
+
+	return ret;
+}
+
+// whether the command may reach the target twice. a retry is sent when the aps ack is
+// missing, which also happens when the command arrived and only the ack was lost. on and
+// off leave the target as the first copy did; toggle flips it back and any other command
+// fires its action again, so those are only retried when their frame carries the event
+// stamp the coordinator drops repeats by.
+static bool delivery_repeatable (zb_uint16_t cmd_id)
+{
+	if (IS_ENABLED(CONFIG_APP_EVENT_STAMPS)) {
+		return true;
+	}
+
+	return (cmd_id == ZB_ZCL_CMD_ON_OFF_OFF_ID) || (cmd_id == ZB_ZCL_CMD_ON_OFF_ON_ID);
+}
+
+static void delivery_attempt (zb_bufid_t bufid, zb_uint16_t index)
+{
+	slots[index].bufid = bufid;
+	send_cb (bufid, slots[index].cmd_id);
+}
+
+static void delivery_retry (zb_uint8_t index)
+{
+	trace_cb_enter (TRACE_CB_DELIVERY_RETRY);
+
+	// no room to queue the buffer request; wait another backoff
+	if (buf_pressure_get (delivery_attempt, index) != RET_OK) {
+		ZB_SCHEDULE_APP_ALARM (delivery_retry, index, ZB_MILLISECONDS_TO_BEACON_INTERVAL(BACKOFF_MAX_MS));
+	}
+
+	trace_cb_exit (TRACE_CB_DELIVERY_RETRY);
+}
+
+bool delivery_confirm (zb_bufid_t bufid)
+{
+	zb_zcl_command_send_status_t *status = ZB_BUF_GET_PARAM(bufid, zb_zcl_command_send_status_t);
+	size_t i;
+
+	for (i = 0; i < MAX_INFLIGHT; i++) {
+		if (slots[i].used && (slots[i].bufid == bufid)) {
+			break;
+		}
+	}
+
+	// sent without a slot
+	if (i == MAX_INFLIGHT) {
+		return true;
+	}
+
+	struct delivery_slot *slot = &slots[i];
+	struct delivery_stats *st = delivery_ep_stats (slot->dst_ep, false);
+
+	slot->bufid = ZB_BUF_INVALID;
+
+	if (status->status == RET_OK) {
+		uint32_t latency_ms = k_uptime_get_32 () - slot->start_ms;
+
+		if (st != NULL) {
+			st->delivered++;
+			st->latency_ms_sum += latency_ms;
+			st->latency_ms_max = MAX(st->latency_ms_max, latency_ms);
+		}
+		slot->used = false;
+		return true;
+	}
+
+	if ((slot->attempt >= RETRIES) || !delivery_repeatable (slot->cmd_id)) {
+		if (st != NULL) {
+			st->failed++;
+		}
+		slot->used = false;
+		return true;
+	}
+
+	// the stack has already retried at the aps layer; back off before trying again so a
+	// parent that is busy or rebooting gets time to recover
+	uint32_t backoff_ms = MIN((uint32_t)BACKOFF_MS << slot->attempt, (uint32_t)BACKOFF_MAX_MS);
+
+	slot->attempt++;
+	if (st != NULL) {
+		st->retries++;
+	}
+
+	ZB_SCHEDULE_APP_ALARM (delivery_retry, i, ZB_MILLISECONDS_TO_BEACON_INTERVAL(backoff_ms));
+	return false;
+}
+
+const struct delivery_stats *delivery_stats (zb_uint8_t dst_ep)
+{
+	return delivery_ep_stats (dst_ep, false);
+}
@@ -0,0 +1,70 @@
+#include <zephyr/kernel.h>
+
+#ifdef CONFIG_NRF_802154_RADIO_DRIVER
+#include <nrf_802154.h>
+#endif
+
+#include <zboss_api.h>
+
+#include "diagnostics.h"
+#include "poll_policy.h"
+
+static zb_zcl_app_diagnostics_attrs_t *diag;
+static zb_uint16_t parent = 0xFFFF; // parent of the last join
+
+void diagnostics_init (zb_zcl_app_diagnostics_attrs_t *attrs)
+{
+	diag = attrs;
+}
+
+// cheap enough to do on every confirm: a neighbor table lookup and a copy of the radio
+// driver's counters
+static void diagnostics_refresh (void)
+{
+	zb_uint8_t lqi;
+	zb_int8_t rssi;
+
+	if (zb_zdo_get_diag_data (zb_nwk_get_parent (), &lqi, &rssi) == RET_OK) {
+		diag->last_message_lqi = lqi;
+		diag->last_message_rssi = rssi;
+	}
+
+#ifdef CONFIG_NRF_802154_RADIO_DRIVER
+	nrf_802154_stat_counters_t counters;
+
+	nrf_802154_stat_counters_get (&counters);
+	diag->cca_failures = counters.cca_failed_attempts;
+#endif
+
+	diag->polls_estimate = poll_policy_polls_estimate ();
+}
+
+void diagnostics_confirm (zb_bufid_t bufid)
+{
+	zb_zcl_command_send_status_t *status = ZB_BUF_GET_PARAM(bufid, zb_zcl_command_send_status_t);
+
+	if (status->status == RET_OK) {
+		diag->aps_tx_ucast_success++;
+	} else {
+		diag->aps_tx_ucast_fail++;
+	}
+
+	diagnostics_refresh ();
+}
+
+void diagnostics_joined (void)
+{
+	zb_uint16_t now = zb_nwk_get_parent ();
+
+	if ((parent != 0xFFFF) && (now != parent)) {
+		diag->parent_changes++;
+	}
+	parent = now;
+
+	diagnostics_refresh ();
+}
+
+void diagnostics_parent_link_failure (void)
+{
+	diag->poll_failures++;
+}
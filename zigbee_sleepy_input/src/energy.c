@@ -0,0 +1,105 @@
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+
+#include "energy.h"
+#include "leds.h"
+
+// per-event charges from the bikerglen,energy-model node, with typical nrf52840 figures
+// for boards that do not describe their own
+#define ENERGY_NODE DT_NODELABEL(energy_model)
+
+#define TX_CHARGE_NC        DT_PROP_OR(ENERGY_NODE, tx_charge_nc, 10000)
+#define POLL_CHARGE_NC      DT_PROP_OR(ENERGY_NODE, poll_charge_nc, 25000)
+#define SAADC_CHARGE_NC     DT_PROP_OR(ENERGY_NODE, saadc_charge_nc, 1000)
+#define WAKEUP_CHARGE_NC    DT_PROP_OR(ENERGY_NODE, wakeup_charge_nc, 3000)
+#define LED_CURRENT_UA      DT_PROP_OR(ENERGY_NODE, led_current_ua, 2000)
+#define SLEEP_CURRENT_NA    DT_PROP_OR(ENERGY_NODE, sleep_current_na, 3000)
+
+// 1 uAh is 3.6 mC
+#define NC_PER_UAH          3600000ULL
+
+static const uint32_t event_charge_nc[ENERGY_EVENT_COUNT] = {
+	[ENERGY_EVENT_TX]     = TX_CHARGE_NC,
+	[ENERGY_EVENT_POLL]   = POLL_CHARGE_NC,
+	[ENERGY_EVENT_SAADC]  = SAADC_CHARGE_NC,
+	[ENERGY_EVENT_WAKEUP] = WAKEUP_CHARGE_NC,
+};
+
+static struct k_spinlock lock;
+
+static uint32_t events[ENERGY_EVENT_COUNT];
+static uint64_t consumed_nc;
+
+static uint32_t poll_interval_ms;
+static int64_t poll_mark_ms;        // uptime up to which polls have been counted
+static int64_t sleep_mark_ms;       // uptime up to which sleep current has been counted
+static uint32_t led_mark_ms;        // led on-time already counted
+
+void energy_count (enum energy_event event)
+{
+	k_spinlock_key_t key = k_spin_lock (&lock);
+
+	events[event]++;
+	consumed_nc += event_charge_nc[event];
+
+	k_spin_unlock (&lock, key);
+}
+
+// count the polls made at the current interval up to now. call with lock held.
+static void energy_fold_polls (int64_t now)
+{
+	if (poll_interval_ms == 0) {
+		poll_mark_ms = now;
+		return;
+	}
+
+	uint32_t polls = (uint32_t)((now - poll_mark_ms) / poll_interval_ms);
+
+	events[ENERGY_EVENT_POLL] += polls;
+	consumed_nc += (uint64_t)polls * POLL_CHARGE_NC;
+	poll_mark_ms += (int64_t)polls * poll_interval_ms;
+}
+
+void energy_set_poll_interval (uint32_t interval_ms)
+{
+	k_spinlock_key_t key = k_spin_lock (&lock);
+
+	energy_fold_polls (k_uptime_get ());
+	poll_interval_ms = interval_ms;
+
+	k_spin_unlock (&lock, key);
+}
+
+void energy_update (void)
+{
+	uint32_t led_ms = led_on_time_ms ();
+	int64_t now = k_uptime_get ();
+
+	k_spinlock_key_t key = k_spin_lock (&lock);
+
+	energy_fold_polls (now);
+
+	// ua * ms and na * ms / 1000 are both nC
+	consumed_nc += (uint64_t)(led_ms - led_mark_ms) * LED_CURRENT_UA;
+	led_mark_ms = led_ms;
+
+	consumed_nc += ((uint64_t)(now - sleep_mark_ms) * SLEEP_CURRENT_NA) / 1000;
+	sleep_mark_ms = now;
+
+	k_spin_unlock (&lock, key);
+}
+
+uint32_t energy_events (enum energy_event event)
+{
+	return events[event];
+}
+
+uint32_t energy_led_on_time_ms (void)
+{
+	return led_mark_ms;
+}
+
+uint32_t energy_consumed_uah (void)
+{
+	return (uint32_t)(consumed_nc / NC_PER_UAH);
+}
@@ -0,0 +1,411 @@
+#include <zephyr/kernel.h>
+#include <errno.h>
+#include <string.h>
+
+#ifdef CONFIG_APP_EVENT_LOG_FLASH
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+#endif
+
+#include <zboss_api.h>
+
+#include "event_log.h"
+
+#define QUEUE_SIZE          CONFIG_APP_EVENT_QUEUE_SIZE
+#define REPLAY_BATCH        CONFIG_APP_EVENT_REPLAY_BATCH
+#define REPLAY_INTERVAL_MS  CONFIG_APP_EVENT_REPLAY_INTERVAL_MS
+
+static void event_log_replay (zb_uint8_t param);
+
+static event_log_send_t send_cb;
+static uint16_t boot;
+static uint32_t dropped;
+
+// ram queue, oldest entry at head
+static struct event_log_entry queue[QUEUE_SIZE];
+static size_t head;
+static size_t count;
+
+#ifdef CONFIG_APP_EVENT_LOG_FLASH
+
+// The log fills the storage partition slot by slot and wraps around, erasing each page just
+// before its first slot is written again, so every page sees the same number of erases.
+// Spilled events and replay marks share the log; a mark records the last event replayed so
+// the position survives a reboot without rewriting any slot. One mark is written at every
+// boot, so the highest boot number in the log counts the boots.
+
+#define LOG_PAGE_SIZE       4096
+#define LOG_SEQ_ERASED      0xffffffff
+
+enum log_type {
+	LOG_TYPE_EVENT = 1,         // spilled event
+	LOG_TYPE_MARK  = 2,         // events up to the seq in time_ms have been replayed
+};
+
+struct log_record {
+	uint32_t seq;               // write order, LOG_SEQ_ERASED in an unwritten slot
+	uint32_t time_ms;
+	uint16_t boot;
+	uint16_t cmd_id;
+	uint8_t type;
+	uint8_t input;
+	uint16_t crc;               // crc16 ccitt of the fields above
+};
+
+BUILD_ASSERT(sizeof(struct log_record) == 16, "log record must be a whole number of flash words");
+
+#define LOG_SLOTS_PER_PAGE  (LOG_PAGE_SIZE / sizeof(struct log_record))
+
+static const struct flash_area *fa;
+static uint32_t log_slots;          // 0 while the log is unavailable
+static uint32_t write_slot;         // next slot to write
+static uint32_t read_slot;          // oldest slot that may hold an event not replayed yet
+static uint32_t log_count;          // events in the log not replayed yet
+static uint32_t next_seq = 1;
+static uint32_t replayed_seq;       // seq of the last event replayed
+
+static uint16_t log_crc (const struct log_record *rec)
+{
+	return crc16_ccitt (0xffff, (const uint8_t *)rec, offsetof(struct log_record, crc));
+}
+
+static int log_read (uint32_t slot, struct log_record *rec)
+{
+	if (flash_area_read (fa, slot * sizeof(*rec), rec, sizeof(*rec)) != 0) {
+		return -EIO;
+	}
+
+	if (rec->seq == LOG_SEQ_ERASED) {
+		return -ENOENT;
+	}
+
+	// a write torn by a reset leaves a slot that is neither erased nor valid
+	if (rec->crc != log_crc (rec)) {
+		return -EBADMSG;
+	}
+
+	return 0;
+}
+
+static bool log_blank (uint32_t slot)
+{
+	uint8_t bytes[sizeof(struct log_record)];
+
+	if (flash_area_read (fa, slot * sizeof(bytes), bytes, sizeof(bytes)) != 0) {
+		return false;
+	}
+
+	for (size_t i = 0; i < sizeof(bytes); i++) {
+		if (bytes[i] != 0xff) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void log_erase_page (uint32_t slot)
+{
+	struct log_record rec;
+
+	// the page still holds the oldest events when the reader is in it; they are lost
+	if ((log_count > 0) && ((read_slot / LOG_SLOTS_PER_PAGE) == (slot / LOG_SLOTS_PER_PAGE))) {
+		for (uint32_t s = read_slot; s < slot + LOG_SLOTS_PER_PAGE; s++) {
+			if ((log_read (s, &rec) == 0) && (rec.type == LOG_TYPE_EVENT) &&
+			    (rec.seq > replayed_seq) && (log_count > 0)) {
+				replayed_seq = rec.seq;
+				log_count--;
+				dropped++;
+			}
+		}
+		read_slot = (slot + LOG_SLOTS_PER_PAGE) % log_slots;
+	}
+
+	flash_area_erase (fa, slot * sizeof(rec), LOG_PAGE_SIZE);
+}
+
+static int log_write (struct log_record *rec)
+{
+	for (uint32_t tries = 0; tries < log_slots; tries++) {
+		uint32_t slot = write_slot;
+		write_slot = (write_slot + 1) % log_slots;
+
+		if ((slot % LOG_SLOTS_PER_PAGE) == 0) {
+			log_erase_page (slot);
+		} else if (!log_blank (slot)) {
+			continue;
+		}
+
+		rec->seq = next_seq++;
+		rec->crc = log_crc (rec);
+		if (flash_area_write (fa, slot * sizeof(*rec), rec, sizeof(*rec)) != 0) {
+			continue;
+		}
+
+		if (rec->type == LOG_TYPE_EVENT) {
+			if (log_count == 0) {
+				read_slot = slot;
+			}
+			log_count++;
+		}
+		return 0;
+	}
+
+	return -ENOSPC;
+}
+
+static int log_init (void)
+{
+	struct log_record rec;
+	uint32_t max_seq = 0;
+	uint32_t min_seq = LOG_SEQ_ERASED;
+	bool found = false;
+
+	log_slots = 0;
+	write_slot = 0;
+	read_slot = 0;
+	log_count = 0;
+	replayed_seq = 0;
+
+	if (flash_area_open (FIXED_PARTITION_ID(storage_partition), &fa) != 0) {
+		return -ENODEV;
+	}
+
+	log_slots = (fa->fa_size / LOG_PAGE_SIZE) * LOG_SLOTS_PER_PAGE;
+	if (log_slots == 0) {
+		return -ENOSPC;
+	}
+
+	// newest record, newest replay mark and highest boot number
+	for (uint32_t slot = 0; slot < log_slots; slot++) {
+		if (log_read (slot, &rec) != 0) {
+			continue;
+		}
+
+		if (!found || (rec.seq > max_seq)) {
+			max_seq = rec.seq;
+			write_slot = (slot + 1) % log_slots;
+		}
+		if (!found || (rec.boot >= boot)) {
+			boot = rec.boot + 1;
+		}
+		if ((rec.type == LOG_TYPE_MARK) && (rec.time_ms > replayed_seq)) {
+			replayed_seq = rec.time_ms;
+		}
+		found = true;
+	}
+
+	next_seq = max_seq + 1;
+
+	// oldest event not replayed yet
+	for (uint32_t slot = 0; slot < log_slots; slot++) {
+		if ((log_read (slot, &rec) == 0) && (rec.type == LOG_TYPE_EVENT) &&
+		    (rec.seq > replayed_seq)) {
+			if (rec.seq < min_seq) {
+				min_seq = rec.seq;
+				read_slot = slot;
+			}
+			log_count++;
+		}
+	}
+
+	// a mark carrying this boot's number, so the next boot counts past it even when no event
+	// is held back. a full log loses its oldest event to it, as it would to the next spill.
+	struct log_record mark = {
+		.time_ms = replayed_seq,
+		.boot = boot,
+		.type = LOG_TYPE_MARK,
+	};
+	log_write (&mark);
+
+	return 0;
+}
+
+// oldest event in the log not replayed yet
+static bool log_peek (struct event_log_entry *entry)
+{
+	struct log_record rec;
+
+	for (uint32_t tries = 0; (log_count > 0) && (tries < log_slots); tries++) {
+		if ((log_read (read_slot, &rec) == 0) && (rec.type == LOG_TYPE_EVENT) &&
+		    (rec.seq > replayed_seq)) {
+			entry->time_ms = rec.time_ms;
+			entry->boot = rec.boot;
+			entry->cmd_id = rec.cmd_id;
+			entry->input = rec.input;
+			return true;
+		}
+		read_slot = (read_slot + 1) % log_slots;
+	}
+
+	// counted events that are no longer readable
+	log_count = 0;
+	return false;
+}
+
+static void log_consume (void)
+{
+	struct log_record rec;
+
+	if (log_read (read_slot, &rec) == 0) {
+		replayed_seq = rec.seq;
+	}
+	read_slot = (read_slot + 1) % log_slots;
+	log_count--;
+}
+
+static void log_mark (void)
+{
+	struct log_record rec = {
+		.time_ms = replayed_seq,
+		.boot = boot,
+		.type = LOG_TYPE_MARK,
+	};
+
+	// never evict events to record progress; a later mark records it instead
+	if (((write_slot % LOG_SLOTS_PER_PAGE) == 0) && (log_count > 0) &&
+	    ((read_slot / LOG_SLOTS_PER_PAGE) == (write_slot / LOG_SLOTS_PER_PAGE))) {
+		return;
+	}
+
+	log_write (&rec);
+}
+
+// move every queued event to the log, oldest first
+static int log_spill (void)
+{
+	if (log_slots == 0) {
+		return -ENODEV;
+	}
+
+	while (count > 0) {
+		struct event_log_entry *entry = &queue[head];
+		struct log_record rec = {
+			.time_ms = entry->time_ms,
+			.boot = entry->boot,
+			.cmd_id = entry->cmd_id,
+			.type = LOG_TYPE_EVENT,
+			.input = entry->input,
+		};
+
+		if (log_write (&rec) != 0) {
+			return -EIO;
+		}
+
+		head = (head + 1) % QUEUE_SIZE;
+		count--;
+	}
+
+	return 0;
+}
+
+#else
+
+static uint32_t log_count;
+
+static int log_init (void) { return 0; }
+static bool log_peek (struct event_log_entry *entry) { return false; }
+static void log_consume (void) { }
+static void log_mark (void) { }
+static int log_spill (void) { return -ENOTSUP; }
+
+#endif
+
+int event_log_init (event_log_send_t send)
+{
+	// everything but the flash log is lost at a reboot
+	send_cb = send;
+	boot = 0;
+	dropped = 0;
+	head = 0;
+	count = 0;
+	return log_init ();
+}
+
+void event_log_push (uint8_t input, uint16_t cmd_id, uint32_t time_ms)
+{
+	// the log keeps the queue in order, so spill all of it rather than just the oldest
+	if ((count == QUEUE_SIZE) && (log_spill () != 0)) {
+		head = (head + 1) % QUEUE_SIZE;
+		count--;
+		dropped++;
+	}
+
+	struct event_log_entry *entry = &queue[(head + count) % QUEUE_SIZE];
+	entry->time_ms = time_ms;
+	entry->boot = boot;
+	entry->cmd_id = cmd_id;
+	entry->input = input;
+	count++;
+}
+
+bool event_log_pending (void)
+{
+	return (log_count > 0) || (count > 0);
+}
+
+void event_log_replay_start (void)
+{
+	// leave the first interval to the coordinator's interview of the device
+	ZB_SCHEDULE_APP_ALARM_CANCEL (event_log_replay, ZB_ALARM_ANY_PARAM);
+	ZB_SCHEDULE_APP_ALARM (event_log_replay, 0, ZB_MILLISECONDS_TO_BEACON_INTERVAL(REPLAY_INTERVAL_MS));
+}
+
+void event_log_replay_stop (void)
+{
+	ZB_SCHEDULE_APP_ALARM_CANCEL (event_log_replay, ZB_ALARM_ANY_PARAM);
+}
+
+// one batch, the log first since everything in it is older than the ram queue
+static void event_log_replay (zb_uint8_t param)
+{
+	struct event_log_entry entry;
+	bool from_log = false;
+
+	ZVUNUSED(param);
+
+	for (int sent = 0; sent < REPLAY_BATCH; sent++) {
+		if (log_peek (&entry)) {
+			if (send_cb (&entry) != 0) {
+				break;
+			}
+			log_consume ();
+			from_log = true;
+		} else if (count > 0) {
+			if (send_cb (&queue[head]) != 0) {
+				break;
+			}
+			head = (head + 1) % QUEUE_SIZE;
+			count--;
+		} else {
+			break;
+		}
+	}
+
+	if (from_log) {
+		log_mark ();
+	}
+
+	if (event_log_pending ()) {
+		ZB_SCHEDULE_APP_ALARM (event_log_replay, 0, ZB_MILLISECONDS_TO_BEACON_INTERVAL(REPLAY_INTERVAL_MS));
+	}
+}
+
+int64_t event_log_age_ms (const struct event_log_entry *entry)
+{
+	if (entry->boot != boot) {
+		return -1;
+	}
+
+	return (int64_t)(k_uptime_get_32 () - entry->time_ms);
+}
+
+uint16_t event_log_boot (void)
+{
+	return boot;
+}
+
+uint32_t event_log_dropped (void)
+{
+	return dropped;
+}
@@ -0,0 +1,97 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include <zboss_api.h>
+
+#include "event_stamp.h"
+
+// frames waiting for a buffer, an aps ack or a retry at once. a stamp is held through every
+// retry backoff, and frames sent without a reliable send slot hold one too, so a burst of
+// events while the parent is unreachable can use them all; main.c then holds the event back
+// in the event log until a stamp is free.
+#define STAMP_COUNT         16
+
+BUILD_ASSERT(STAMP_COUNT <= 256, "stamp slot must fit a byte");
+
+static struct event_stamp stamps[STAMP_COUNT];
+static uint32_t next_seq;
+
+zb_ret_t event_stamp_add (zb_uint8_t input, zb_uint16_t cmd_id, int64_t age_ms, zb_uint16_t *param)
+{
+	size_t slot;
+
+	for (slot = 0; slot < STAMP_COUNT; slot++) {
+		if (!stamps[slot].used) {
+			break;
+		}
+	}
+
+	if (slot == STAMP_COUNT) {
+		return RET_NO_MEMORY;
+	}
+
+	struct event_stamp *stamp = &stamps[slot];
+
+	stamp->used = true;
+	stamp->seq = next_seq++;
+	stamp->bufid = ZB_BUF_INVALID;
+	stamp->input = input;
+	stamp->time_known = (age_ms >= 0);
+	stamp->time_ms = stamp->time_known ? (k_uptime_get_32 () - (uint32_t)age_ms) : 0;
+
+	*param = (zb_uint16_t)((slot << 8) | (cmd_id & 0xFF));
+	return RET_OK;
+}
+
+void event_stamp_drop (zb_uint16_t param)
+{
+	struct event_stamp *stamp = (struct event_stamp *)event_stamp_get (param);
+
+	if (stamp == NULL) {
+		return;
+	}
+
+	if (stamp->seq + 1 == next_seq) {
+		next_seq--;
+	}
+	stamp->used = false;
+}
+
+const struct event_stamp *event_stamp_get (zb_uint16_t param)
+{
+	zb_uint8_t slot = param >> 8;
+
+	if ((slot >= STAMP_COUNT) || !stamps[slot].used) {
+		return NULL;
+	}
+
+	return &stamps[slot];
+}
+
+void event_stamp_sent (zb_uint16_t param, zb_bufid_t bufid)
+{
+	struct event_stamp *stamp = (struct event_stamp *)event_stamp_get (param);
+
+	if (stamp != NULL) {
+		stamp->bufid = bufid;
+	}
+}
+
+void event_stamp_done (zb_bufid_t bufid)
+{
+	for (size_t slot = 0; slot < STAMP_COUNT; slot++) {
+		if (stamps[slot].used && (stamps[slot].bufid == bufid)) {
+			stamps[slot].used = false;
+			return;
+		}
+	}
+}
+
+uint32_t event_stamp_age_ms (const struct event_stamp *stamp)
+{
+	if (!stamp->time_known) {
+		return EVENT_STAMP_AGE_UNKNOWN;
+	}
+
+	return k_uptime_get_32 () - stamp->time_ms;
+}
@@ -0,0 +1,203 @@
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <errno.h>
+#include <string.h>
+
+#include <zboss_api.h>
+
+#include "fast_rejoin.h"
+
+#define CHANNEL_MASK        CONFIG_ZIGBEE_CHANNEL_MASK
+
+// time a rejoin on the cached channel gets before the stack's rejoin over every channel
+#define REJOIN_TIMEOUT_MS   3000
+
+// network the device was last joined to
+struct rejoin_cache {
+	zb_uint8_t channel;         // 0 while nothing is cached
+	zb_uint16_t pan_id;
+	zb_ext_pan_id_t ext_pan_id;
+	zb_uint16_t parent;         // short address of the parent
+};
+
+static void fast_rejoin_timeout (zb_uint8_t param);
+
+static struct rejoin_cache cache;
+
+static int64_t start_ms;            // uptime the join being timed started at
+static uint32_t slept_ms;           // time slept since then
+static uint32_t join_ms;
+static uint32_t radio_ms;
+static uint32_t cached_joins;
+static uint32_t cached_failures;
+static bool rejoining;              // a rejoin on the cached channel is under way
+
+static int fast_rejoin_set (const char *name, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+	if (!settings_name_steq (name, "net", NULL)) {
+		return -ENOENT;
+	}
+
+	// a cache from another firmware layout is ignored
+	if ((len != sizeof(cache)) || (read_cb (cb_arg, &cache, sizeof(cache)) != sizeof(cache))) {
+		memset (&cache, 0, sizeof(cache));
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(fast_rejoin, "rejoin", NULL, fast_rejoin_set, NULL, NULL);
+
+// steering at start and after a leave scans the primary set and only then the secondary set
+static void fast_rejoin_scan_first (zb_uint8_t channel)
+{
+	if ((channel == 0) || !(CHANNEL_MASK & BIT(channel))) {
+		zb_set_bdb_primary_channel_set (CHANNEL_MASK);
+		zb_set_bdb_secondary_channel_set (0);
+		return;
+	}
+
+	zb_set_bdb_primary_channel_set (BIT(channel));
+	zb_set_bdb_secondary_channel_set (CHANNEL_MASK & ~BIT(channel));
+}
+
+int fast_rejoin_init (void)
+{
+	int err;
+
+	start_ms = k_uptime_get ();
+
+	err = settings_subsys_init ();
+	if (err == 0) {
+		err = settings_load_subtree ("rejoin");
+	}
+
+	fast_rejoin_scan_first (cache.channel);
+	return err;
+}
+
+void fast_rejoin_joined (void)
+{
+	struct rejoin_cache now;
+
+	// cleared so the padding compares equal too
+	memset (&now, 0, sizeof(now));
+	now.channel = zb_get_current_channel ();
+	now.pan_id = zb_get_pan_id ();
+	zb_get_extended_pan_id (now.ext_pan_id);
+	now.parent = zb_nwk_get_parent ();
+
+	join_ms = (uint32_t)(k_uptime_get () - start_ms);
+	radio_ms = join_ms - MIN(slept_ms, join_ms);
+
+	if (rejoining) {
+		rejoining = false;
+		ZB_SCHEDULE_APP_ALARM_CANCEL (fast_rejoin_timeout, ZB_ALARM_ANY_PARAM);
+		cached_joins++;
+	}
+
+	// a parent lost later is looked for on this channel first
+	fast_rejoin_scan_first (now.channel);
+
+	// the parent changes more often than the network, but a write per rejoin is still rare
+	if (memcmp (&cache, &now, sizeof(now)) != 0) {
+		memcpy (&cache, &now, sizeof(cache));
+		settings_save_one ("rejoin/net", &cache, sizeof(cache));
+	}
+}
+
+void fast_rejoin_lost (void)
+{
+	// already timed from the parent link failure
+	if (rejoining) {
+		return;
+	}
+
+	start_ms = k_uptime_get ();
+	slept_ms = 0;
+}
+
+static void fast_rejoin_request (zb_bufid_t bufid)
+{
+	zb_channel_list_t channels;
+
+	zb_channel_list_init (channels);
+	zb_channel_page_list_set_2_4GHz_mask (channels, BIT(cache.channel));
+	zdo_initiate_rejoin (bufid, cache.ext_pan_id, channels, ZB_TRUE);
+
+	ZB_SCHEDULE_APP_ALARM (fast_rejoin_timeout, 0, ZB_MILLISECONDS_TO_BEACON_INTERVAL(REJOIN_TIMEOUT_MS));
+}
+
+// nothing answered on the cached channel, so scan every channel as the stack would have
+static void fast_rejoin_timeout (zb_uint8_t param)
+{
+	ZVUNUSED(param);
+
+	if (!rejoining) {
+		return;
+	}
+	rejoining = false;
+
+	// rejoined without the stack ever reporting the device unjoined
+	if (ZB_JOINED ()) {
+		cached_joins++;
+		return;
+	}
+
+	cached_failures++;
+	zb_zdo_rejoin_backoff_start (ZB_FALSE);
+}
+
+bool fast_rejoin_start (void)
+{
+	if (rejoining || (cache.channel == 0) || !(CHANNEL_MASK & BIT(cache.channel))) {
+		return false;
+	}
+
+	if (zb_buf_get_out_delayed (fast_rejoin_request) != RET_OK) {
+		return false;
+	}
+
+	fast_rejoin_lost ();
+	rejoining = true;
+	return true;
+}
+
+void fast_rejoin_forget (void)
+{
+	if (rejoining) {
+		rejoining = false;
+		ZB_SCHEDULE_APP_ALARM_CANCEL (fast_rejoin_timeout, ZB_ALARM_ANY_PARAM);
+	}
+
+	memset (&cache, 0, sizeof(cache));
+	settings_delete ("rejoin/net");
+	fast_rejoin_scan_first (0);
+	fast_rejoin_lost ();
+}
+
+void fast_rejoin_slept (uint32_t ms)
+{
+	slept_ms += ms;
+}
+
+uint32_t fast_rejoin_join_ms (void)
+{
+	return join_ms;
+}
+
+uint32_t fast_rejoin_radio_ms (void)
+{
+	return radio_ms;
+}
+
+uint32_t fast_rejoin_cached_joins (void)
+{
+	return cached_joins;
+}
+
+uint32_t fast_rejoin_cached_failures (void)
+{
+	return cached_failures;
+}
@@ -0,0 +1,100 @@
+#include <zephyr/kernel.h>
+
+#include <zboss_api.h>
+
+#include "gesture.h"
+
+#define MULTI_PRESS_WINDOW_MS   CONFIG_APP_GESTURE_MULTI_PRESS_WINDOW_MS
+#define LONG_PRESS_MS           CONFIG_APP_GESTURE_LONG_PRESS_MS
+#define HOLD_REPEAT_MS          CONFIG_APP_GESTURE_HOLD_REPEAT_MS
+#define MAX_PRESSES             CONFIG_APP_GESTURE_MAX_PRESSES
+
+// inputs with a state machine, by bit position
+#define MAX_INPUTS              8
+
+BUILD_ASSERT(GESTURE_SINGLE + MAX_PRESSES - 1 <= GESTURE_TRIPLE, "no gesture for that many presses");
+
+struct gesture_state {
+	uint8_t presses;            // short presses counted in the current gesture
+	bool pressed;
+	bool held;                  // the current press became a long press
+	uint32_t edge_cycles;       // last edge or timeout of the current gesture
+};
+
+static void gesture_timeout (zb_uint8_t input);
+
+static gesture_handler_t handler_cb;
+static struct gesture_state state[MAX_INPUTS];
+
+void gesture_init (gesture_handler_t handler)
+{
+	handler_cb = handler;
+}
+
+static void gesture_end (uint8_t input, enum gesture gesture)
+{
+	struct gesture_state *st = &state[input];
+
+	handler_cb (input, gesture, st->edge_cycles);
+	st->presses = 0;
+	st->held = false;
+}
+
+void gesture_edge (uint8_t input, bool pressed, uint32_t edge_cycles)
+{
+	if (input >= MAX_INPUTS) {
+		return;
+	}
+
+	struct gesture_state *st = &state[input];
+
+	if (pressed == st->pressed) {
+		return;
+	}
+
+	ZB_SCHEDULE_APP_ALARM_CANCEL (gesture_timeout, input);
+	st->pressed = pressed;
+	st->edge_cycles = edge_cycles;
+
+	if (pressed) {
+		st->presses++;
+		ZB_SCHEDULE_APP_ALARM (gesture_timeout, input, ZB_MILLISECONDS_TO_BEACON_INTERVAL(LONG_PRESS_MS));
+		return;
+	}
+
+	if (st->held) {
+		gesture_end (input, GESTURE_LONG_RELEASE);
+	} else if (st->presses >= MAX_PRESSES) {
+		// nothing longer to wait for
+		gesture_end (input, GESTURE_SINGLE + st->presses - 1);
+	} else {
+		ZB_SCHEDULE_APP_ALARM (gesture_timeout, input, ZB_MILLISECONDS_TO_BEACON_INTERVAL(MULTI_PRESS_WINDOW_MS));
+	}
+}
+
+// the long press time passed with the input held, or the multi-press window passed without
+// another press
+static void gesture_timeout (zb_uint8_t input)
+{
+	struct gesture_state *st = &state[input];
+
+	// the timeout, not an edge, completes the gesture
+	st->edge_cycles = k_cycle_get_32 ();
+
+	if (!st->pressed) {
+		gesture_end (input, GESTURE_SINGLE + st->presses - 1);
+		return;
+	}
+
+	// a press held after short presses is a long press; the short presses are not reported
+	if (!st->held) {
+		st->held = true;
+		handler_cb (input, GESTURE_LONG, st->edge_cycles);
+	} else {
+		handler_cb (input, GESTURE_HOLD, st->edge_cycles);
+	}
+
+	if (HOLD_REPEAT_MS > 0) {
+		ZB_SCHEDULE_APP_ALARM (gesture_timeout, input, ZB_MILLISECONDS_TO_BEACON_INTERVAL(HOLD_REPEAT_MS));
+	}
+}
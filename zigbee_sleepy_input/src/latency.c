@@ -0,0 +1,149 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/math_extras.h>
+#include <zephyr/sys/byteorder.h>
+
+#ifdef CONFIG_USE_SEGGER_RTT
+#include <SEGGER_RTT.h>
+#define latency_printf(...) SEGGER_RTT_printf (0, __VA_ARGS__)
+#else
+#define latency_printf(...) printk (__VA_ARGS__)
+#endif
+
+#include "latency.h"
+
+// commands waiting for a buffer, keyed on the frame parameter they requested it with
+#define PENDING_SIZE  8
+
+// commands handed to the stack and waiting for their confirm
+#define INFLIGHT_SIZE 4
+
+struct latency_stamp {
+	zb_bufid_t bufid;
+	zb_uint16_t param;          // frame parameter of a pending command
+	bool pending;
+	uint32_t edge;              // first gpio edge of the input change
+	uint32_t start;             // start of the stage in progress
+};
+
+static const char *const stage_names[LATENCY_STAGE_COUNT] = {
+	"settle", "dispatch", "buffer", "air", "total",
+};
+
+static struct k_spinlock lock;
+static uint16_t histogram[LATENCY_STAGE_COUNT][LATENCY_BUCKET_COUNT];
+
+static struct latency_stamp pending[PENDING_SIZE];
+
+static struct latency_stamp inflight[INFLIGHT_SIZE];
+
+static uint32_t confirmed;
+
+void latency_record (enum latency_stage stage, uint32_t start_cycles, uint32_t end_cycles)
+{
+	uint32_t ms = k_cyc_to_ms_floor32 (end_cycles - start_cycles);
+	uint32_t bucket = (ms == 0) ? 0 : MIN(32 - u32_count_leading_zeros (ms), LATENCY_BUCKET_COUNT - 1);
+
+	k_spinlock_key_t key = k_spin_lock (&lock);
+
+	// saturate instead of wrapping so a full bucket still reads as the largest
+	if (histogram[stage][bucket] != UINT16_MAX) {
+		histogram[stage][bucket]++;
+	}
+
+	k_spin_unlock (&lock, key);
+}
+
+void latency_cmd_queued (zb_uint16_t param, uint32_t edge_cycles)
+{
+	for (size_t i = 0; i < PENDING_SIZE; i++) {
+		if (!pending[i].pending) {
+			pending[i].pending = true;
+			pending[i].param = param;
+			pending[i].edge = edge_cycles;
+			pending[i].start = k_cycle_get_32 ();
+			return;
+		}
+	}
+}
+
+void latency_cmd_sending (zb_uint16_t param, zb_bufid_t bufid)
+{
+	uint32_t now = k_cycle_get_32 ();
+	struct latency_stamp *stamp = NULL;
+
+	// the oldest command queued with the parameter. retries and replayed events were never
+	// queued here, so they find none unless a new command with the same parameter waits;
+	// zboss hands out buffers in request order, so that command's buffer comes first.
+	for (size_t i = 0; i < PENDING_SIZE; i++) {
+		if (pending[i].pending && (pending[i].param == param) &&
+		    ((stamp == NULL) || ((now - pending[i].start) > (now - stamp->start)))) {
+			stamp = &pending[i];
+		}
+	}
+
+	if (stamp == NULL) {
+		return;
+	}
+
+	stamp->pending = false;
+	latency_record (LATENCY_STAGE_BUFFER, stamp->start, now);
+
+	for (size_t i = 0; i < INFLIGHT_SIZE; i++) {
+		if (inflight[i].bufid == ZB_BUF_INVALID) {
+			inflight[i].bufid = bufid;
+			inflight[i].edge = stamp->edge;
+			inflight[i].start = now;
+			return;
+		}
+	}
+}
+
+void latency_cmd_sent (zb_bufid_t bufid)
+{
+	uint32_t now = k_cycle_get_32 ();
+
+	for (size_t i = 0; i < INFLIGHT_SIZE; i++) {
+		if (inflight[i].bufid == bufid) {
+			latency_record (LATENCY_STAGE_AIR, inflight[i].start, now);
+			latency_record (LATENCY_STAGE_TOTAL, inflight[i].edge, now);
+			inflight[i].bufid = ZB_BUF_INVALID;
+			break;
+		}
+	}
+
+	if ((CONFIG_APP_LATENCY_DUMP_INTERVAL > 0) &&
+	    ((++confirmed % CONFIG_APP_LATENCY_DUMP_INTERVAL) == 0)) {
+		latency_dump ();
+	}
+}
+
+void latency_encode (enum latency_stage stage, zb_uint8_t *octets)
+{
+	k_spinlock_key_t key = k_spin_lock (&lock);
+
+	octets[0] = 2 * LATENCY_BUCKET_COUNT;
+	for (size_t i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+		sys_put_le16 (histogram[stage][i], &octets[1 + 2 * i]);
+	}
+
+	k_spin_unlock (&lock, key);
+}
+
+void latency_dump (void)
+{
+	uint16_t copy[LATENCY_BUCKET_COUNT];
+
+	latency_printf ("latency histograms, bucket n counts [2^(n-1), 2^n) ms\n");
+
+	for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+		k_spinlock_key_t key = k_spin_lock (&lock);
+		memcpy (copy, histogram[stage], sizeof(copy));
+		k_spin_unlock (&lock, key);
+
+		latency_printf ("%-8s", stage_names[stage]);
+		for (int i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+			latency_printf (" %u", copy[i]);
+		}
+		latency_printf ("\n");
+	}
+}
@@ -0,0 +1,70 @@
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/gpio.h>
+
+#include "leds.h"
+
+#define LEDS_NODE DT_PATH(leds)
+
+#define GPIO_SPEC_AND_COMMA(button_or_led) GPIO_DT_SPEC_GET(button_or_led, gpios),
+
+static const struct gpio_dt_spec leds[] = {
+#if DT_NODE_EXISTS(LEDS_NODE)
+	DT_FOREACH_CHILD(LEDS_NODE, GPIO_SPEC_AND_COMMA)
+#endif
+};
+
+// on-time bookkeeping: uptime each lit led was turned on and the total of finished periods
+static uint32_t on_since_ms[ARRAY_SIZE(leds)];
+static uint32_t led_state;
+static uint32_t on_total_ms;
+
+void led_init (void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(leds); i++) {
+		gpio_pin_configure_dt(&leds[i], GPIO_OUTPUT_INACTIVE);
+	}
+}
+
+void led_set (uint8_t led_idx, uint32_t val)
+{
+	if (led_idx >= ARRAY_SIZE(leds)) {
+		return;
+	}
+	gpio_pin_set_dt(&leds[led_idx], val);
+
+	uint32_t now = k_uptime_get_32 ();
+	bool was_on = (led_state & BIT(led_idx)) != 0;
+
+	if (val && !was_on) {
+		on_since_ms[led_idx] = now;
+		led_state |= BIT(led_idx);
+	} else if (!val && was_on) {
+		on_total_ms += now - on_since_ms[led_idx];
+		led_state &= ~BIT(led_idx);
+	}
+}
+
+uint32_t led_on_time_ms (void)
+{
+	uint32_t now = k_uptime_get_32 ();
+	uint32_t total = on_total_ms;
+
+	for (size_t i = 0; i < ARRAY_SIZE(leds); i++) {
+		if (led_state & BIT(i)) {
+			total += now - on_since_ms[i];
+		}
+	}
+	return total;
+}
+
+void led_set_on (uint8_t led_idx)
+{
+	led_set (led_idx, 1);
+}
+
+void led_set_off (uint8_t led_idx)
+{
+	led_set (led_idx, 0);
+}
@@ -0,0 +1,1420 @@
+//---------------------------------------------------------------------------------------------
+// includes
+//
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/sys/math_extras.h>
+#include <zephyr/sys/reboot.h>
+#include <errno.h>
+#include <ram_pwrdn.h>
+
+#include <zboss_api.h>
+#include <zboss_api_addons.h>
+#include <zb_zcl_reporting.h>
+#include <zigbee/zigbee_app_utils.h>
+#include <zigbee/zigbee_error_handler.h>
+#include <zb_nrf_platform.h>
+#include "zb_mem_config_custom.h"
+#include "zb_four_input.h"
+#include "leds.h"
+#include "buttons.h"
+#include "latency.h"
+#include "energy.h"
+#include "battery.h"
+#include "reporting.h"
+#include "battery_alarm.h"
+#include "poll_policy.h"
+#include "event_log.h"
+#include "delivery.h"
+#include "buf_pressure.h"
+#include "event_stamp.h"
+#include "gesture.h"
+#include "fast_rejoin.h"
+#include "spi_flash.h"
+#include "stack_watermark.h"
+#include "diagnostics.h"
+#include "trace.h"
+#include "ota.h"
+#include "sleepy_input.h"
+
+
+//---------------------------------------------------------------------------------------------
+// defines
+//
+
+// Basic cluster attributes initial values. For more information, see section 3.2.2.2 of the ZCL specification.
+#define FOUR_INPUT_INIT_BASIC_APP_VERSION       01                                  // Version of the application software (1 byte).
+#define FOUR_INPUT_INIT_BASIC_STACK_VERSION     10                                  // Version of the implementation of the Zigbee stack (1 byte).
+#define FOUR_INPUT_INIT_BASIC_HW_VERSION        11                                  // Version of the hardware of the device (1 byte).
+#define FOUR_INPUT_INIT_BASIC_MANUF_NAME        "bikerglen.com"                     // Manufacturer name (32 bytes).
+#define FOUR_INPUT_INIT_BASIC_MODEL_ID          "four-input"                        // Model number assigned by the manufacturer (32-bytes long string).
+#define FOUR_INPUT_INIT_BASIC_DATE_CODE         "20240226"                          // Date provided by the manufacturer of the device in ISO 8601 format (YYYYMMDD), for the first 8 bytes. The remaining 8 bytes are manufacturer-specific.
+#define FOUR_INPUT_INIT_BASIC_POWER_SOURCE      ZB_ZCL_BASIC_POWER_SOURCE_BATTERY   // Type of power source or sources available for the device. For possible values, see section 3.2.2.2.8 of the ZCL specification.
+#define FOUR_INPUT_INIT_BASIC_LOCATION_DESC     "Earth"                             // Description of the physical location of the device (16 bytes). You can modify it during the commisioning process.
+#define FOUR_INPUT_INIT_BASIC_PH_ENV            ZB_ZCL_BASIC_ENV_UNSPECIFIED        // Description of the type of physical environment. For possible values, see section 3.2.2.2.10 of the ZCL specification.
+
+// source endpoint for our device
+#define SOURCE_ENDPOINT            1
+
+// destination short address and endpoint (always endpoint 1 on the coordinator)
+#define DEST_SHORT_ADDR            0x0000
+#define DEST_ENDPOINT              1
+
+// Do not erase NVRAM to save the network parameters after device reboot or
+// power-off. NOTE: If this option is set to ZB_TRUE then do full device erase
+// for all network devices before running other samples.
+#define ERASE_PERSISTENT_CONFIG    ZB_FALSE
+
+// LEDs, every other led stays off
+#define ZIGBEE_NETWORK_STATE_LED   CONFIG_APP_NETWORK_STATE_LED // on: disconnected, blinking: identify, off: normal operation
+
+// Buttons, the inputs before the identify button send the commands in their devicetree nodes
+#define IDENTIFY_BUTTON            SLEEPY_INPUT_IDENTIFY_BUTTON // short press: identify, long press: factory reset
+#define CONTACT_INPUT              BIT(0)                       // contact state with CONFIG_APP_CONTACT_STATE
+
+// maximum number of commands queued by a single call to the button handler
+#define BUTTON_EVENT_QUEUE_SIZE    8
+
+// command ids of the gestures other than a single press, which sends the button's press
+// command: manufacturer specific 0x20 + 8 * input + enum gesture
+#define GESTURE_CMD_BASE           0x20
+#define GESTURE_CMD(input, gesture) (SLEEPY_INPUT_CMD_MANUF | (GESTURE_CMD_BASE + ((input) << 3) + (gesture)))
+
+// completion callback for on/off commands, counts the aps confirm for the diagnostics cluster
+// and times it, retries commands that were not acknowledged and counts the buffer as back
+#define LIGHT_SWITCH_SEND_CB       light_switch_send_cb
+
+// no idea but required for successful compile
+#define bat_num
+
+// read and report battery voltage after an initial delay after joining the network 
+// then read and report battery voltage after the specified period elapses.
+#define READ_BATTERY_VOLTAGE_INITIAL_DELAY K_SECONDS(10)
+#define READ_BATTERY_VOLTAGE_TIMER_PERIOD  K_HOURS(8)
+
+// attribute reporting intervals in seconds
+#define RPT_MIN 0x0001
+#define RPT_MAX 0xFFFE
+
+
+//---------------------------------------------------------------------------------------------
+// typedefs
+//
+
+// attribute storage for battery power config
+struct zb_zcl_power_attrs {
+    zb_uint8_t voltage; // Attribute 3.3.2.2.3.1
+    zb_uint8_t size; // Attribute 3.3.2.2.4.2
+    zb_uint8_t quantity; // Attribute 3.3.2.2.4.4
+    zb_uint8_t rated_voltage; // Attribute 3.3.2.2.4.5
+    zb_uint8_t alarm_mask; // Attribute 3.3.2.2.4.6
+    zb_uint8_t voltage_min_threshold; // Attribute 3.3.2.2.4.7
+    zb_uint8_t percent_remaining; // Attribute 3.3.2.2.3.1
+    zb_uint8_t voltage_threshold_1; // Attribute 3.3.2.2.4.8
+    zb_uint8_t voltage_threshold_2; // Attribute 3.3.2.2.4.8
+    zb_uint8_t voltage_threshold_3; // Attribute 3.3.2.2.4.8
+    zb_uint8_t percent_min_threshold; // Attribute 3.3.2.2.4.9
+    zb_uint8_t percent_threshold_1; // Attribute 3.3.2.2.4.10
+    zb_uint8_t percent_threshold_2; // Attribute 3.3.2.2.4.10
+    zb_uint8_t percent_threshold_3; // Attribute 3.3.2.2.4.10
+    zb_uint32_t alarm_state; // Attribute 3.3.2.2.4.11
+};
+
+typedef struct zb_zcl_power_attrs zb_zcl_power_attrs_t;
+
+#ifdef CONFIG_APP_CONTACT_STATE
+// attribute storage for the binary input cluster holding the contact state
+struct zb_zcl_binary_input_attrs {
+	zb_bool_t out_of_service;
+	zb_bool_t present_value; // ZB_TRUE while the magnet is away from the sensor
+	zb_uint8_t status_flags;
+};
+
+typedef struct zb_zcl_binary_input_attrs zb_zcl_binary_input_attrs_t;
+#endif
+
+// attribute storage for our device
+struct zb_device_ctx {
+	zb_zcl_basic_attrs_ext_t basic_attr;
+	zb_zcl_identify_attrs_t identify_attr;
+	zb_zcl_power_attrs_t power_attr;
+	zb_zcl_app_diagnostics_attrs_t diagnostics_attr;
+#ifdef CONFIG_APP_CONTACT_STATE
+	zb_zcl_binary_input_attrs_t binary_input_attr;
+#endif
+#ifdef APP_METRICS_CLUSTER
+	zb_zcl_app_metrics_attrs_t metrics_attr;
+#endif
+};
+
+// storage for the destination short address and endpoint number
+struct dest_context {
+	zb_uint8_t endpoint;
+	zb_uint16_t short_addr;
+};
+
+
+//---------------------------------------------------------------------------------------------
+// Prototypes
+//
+
+void zboss_signal_handler (zb_bufid_t bufid);
+static void configure_gpio (void);
+static void button_handler (uint32_t button_state, uint32_t has_changed);
+#ifdef CONFIG_APP_GESTURES
+static void gesture_handler (uint8_t input, enum gesture gesture, uint32_t edge_cycles);
+#endif
+#ifdef CONFIG_APP_OTA
+static void ota_evt_handler (const struct zigbee_fota_evt *evt);
+static void zcl_device_cb (zb_bufid_t bufid);
+#endif
+static void dispatch_command (zb_uint8_t input, zb_uint16_t cmd_id, uint32_t edge_cycles);
+static zb_ret_t send_input_command (zb_uint8_t input, zb_uint16_t cmd_id, uint32_t edge_cycles);
+static zb_ret_t send_event (zb_uint8_t input, zb_uint16_t cmd_id, int64_t age_ms, zb_uint16_t *param);
+static zb_ret_t send_command (zb_uint16_t param);
+static void light_switch_send_on_off (zb_bufid_t bufid, zb_uint16_t param);
+static int replay_event (const struct event_log_entry *entry);
+static void light_switch_send_cb (zb_bufid_t bufid);
+static void start_identifying (zb_bufid_t bufid);
+static void identify_cb (zb_bufid_t bufid);
+static void toggle_identify_led (zb_bufid_t bufid);
+static void app_clusters_attr_init (void);
+#ifdef APP_METRICS_CLUSTER
+static void update_metrics_attrs (void);
+#endif
+static zb_uint8_t endpoint_handler (zb_bufid_t bufid);
+#ifdef CONFIG_APP_CONTACT_STATE
+static void update_contact_state (zb_bool_t contact_open);
+#endif
+static void read_battery_voltage_cb (struct k_timer *timer);
+static void read_battery_voltage_work_handler(struct k_work *work);
+static void read_battery_voltage_done (int32_t adc_mv);
+
+
+//---------------------------------------------------------------------------------------------
+// Globals
+//
+
+#if !defined ZB_ED_ROLE
+#error Define ZB_ED_ROLE to compile light switch (End Device) source code.
+#endif
+
+LOG_MODULE_REGISTER (app, LOG_LEVEL_INF);
+
+// attribute storage for our device
+static struct zb_device_ctx dev_ctx;
+
+// storage for the destination short address and endpoint number
+static struct dest_context dest_ctx;
+
+// Declare attribute list for Basic cluster (server).
+ZB_ZCL_DECLARE_BASIC_ATTRIB_LIST_EXT
+(
+	basic_server_attr_list,
+	&dev_ctx.basic_attr.zcl_version,
+	&dev_ctx.basic_attr.app_version,
+	&dev_ctx.basic_attr.stack_version,
+	&dev_ctx.basic_attr.hw_version,
+	dev_ctx.basic_attr.mf_name,
+	dev_ctx.basic_attr.model_id,
+	dev_ctx.basic_attr.date_code,
+	&dev_ctx.basic_attr.power_source,
+	dev_ctx.basic_attr.location_id,
+	&dev_ctx.basic_attr.ph_env,
+	dev_ctx.basic_attr.sw_ver
+);
+
+// Declare attribute list for Identify cluster (client).
+ZB_ZCL_DECLARE_IDENTIFY_CLIENT_ATTRIB_LIST
+(
+	identify_client_attr_list
+);
+
+// Declare attribute list for Identify cluster (server).
+ZB_ZCL_DECLARE_IDENTIFY_SERVER_ATTRIB_LIST
+(
+	identify_server_attr_list,
+	&dev_ctx.identify_attr.identify_time
+);
+
+// Declare attribute list for On/Off cluster (client).
+ZB_ZCL_DECLARE_ON_OFF_CLIENT_ATTRIB_LIST
+(
+	on_off_client_attr_list
+);
+
+// Declare attribute list for power configuration cluster (server).
+ZB_ZCL_DECLARE_POWER_CONFIG_BATTERY_ATTRIB_LIST_EXT(
+	power_config_server_attr_list,
+	&dev_ctx.power_attr.voltage,
+	&dev_ctx.power_attr.size,
+	&dev_ctx.power_attr.quantity,
+	&dev_ctx.power_attr.rated_voltage,
+	&dev_ctx.power_attr.alarm_mask,
+	&dev_ctx.power_attr.voltage_min_threshold,
+	&dev_ctx.power_attr.percent_remaining,
+	&dev_ctx.power_attr.voltage_threshold_1,
+	&dev_ctx.power_attr.voltage_threshold_2,
+	&dev_ctx.power_attr.voltage_threshold_3,
+	&dev_ctx.power_attr.percent_min_threshold,
+	&dev_ctx.power_attr.percent_threshold_1,
+	&dev_ctx.power_attr.percent_threshold_2,
+	&dev_ctx.power_attr.percent_threshold_3,
+	&dev_ctx.power_attr.alarm_state
+);
+
+// Declare attribute list for Alarms cluster (server), which the battery alarms are sent from.
+ZB_ZCL_START_DECLARE_ATTRIB_LIST_CLUSTER_REVISION(alarms_server_attr_list, ZB_ZCL_APP_ALARMS)
+ZB_ZCL_FINISH_DECLARE_ATTRIB_LIST;
+
+// Declare attribute list for Diagnostics cluster (server), read on demand and never reported.
+ZB_ZCL_START_DECLARE_ATTRIB_LIST_CLUSTER_REVISION(diagnostics_server_attr_list, ZB_ZCL_APP_DIAGNOSTICS)
+	ZB_ZCL_SET_APP_DIAGNOSTICS_ATTR_DESC(ZB_ZCL_ATTR_APP_DIAGNOSTICS_APS_TX_UCAST_SUCCESS_ID,
+		&dev_ctx.diagnostics_attr.aps_tx_ucast_success, ZB_ZCL_ATTR_TYPE_U16)
+	ZB_ZCL_SET_APP_DIAGNOSTICS_ATTR_DESC(ZB_ZCL_ATTR_APP_DIAGNOSTICS_APS_TX_UCAST_FAIL_ID,
+		&dev_ctx.diagnostics_attr.aps_tx_ucast_fail, ZB_ZCL_ATTR_TYPE_U16)
+	ZB_ZCL_SET_APP_DIAGNOSTICS_ATTR_DESC(ZB_ZCL_ATTR_APP_DIAGNOSTICS_LAST_MESSAGE_LQI_ID,
+		&dev_ctx.diagnostics_attr.last_message_lqi, ZB_ZCL_ATTR_TYPE_U8)
+	ZB_ZCL_SET_APP_DIAGNOSTICS_ATTR_DESC(ZB_ZCL_ATTR_APP_DIAGNOSTICS_LAST_MESSAGE_RSSI_ID,
+		&dev_ctx.diagnostics_attr.last_message_rssi, ZB_ZCL_ATTR_TYPE_S8)
+	ZB_ZCL_SET_APP_DIAGNOSTICS_MANUF_ATTR_DESC(ZB_ZCL_ATTR_APP_DIAGNOSTICS_CCA_FAILURES_ID,
+		&dev_ctx.diagnostics_attr.cca_failures, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_DIAGNOSTICS_MANUF_ATTR_DESC(ZB_ZCL_ATTR_APP_DIAGNOSTICS_PARENT_CHANGES_ID,
+		&dev_ctx.diagnostics_attr.parent_changes, ZB_ZCL_ATTR_TYPE_U16)
+	ZB_ZCL_SET_APP_DIAGNOSTICS_MANUF_ATTR_DESC(ZB_ZCL_ATTR_APP_DIAGNOSTICS_POLLS_ESTIMATE_ID,
+		&dev_ctx.diagnostics_attr.polls_estimate, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_DIAGNOSTICS_MANUF_ATTR_DESC(ZB_ZCL_ATTR_APP_DIAGNOSTICS_POLL_FAILURES_ID,
+		&dev_ctx.diagnostics_attr.poll_failures, ZB_ZCL_ATTR_TYPE_U32)
+ZB_ZCL_FINISH_DECLARE_ATTRIB_LIST;
+
+#ifdef CONFIG_APP_CONTACT_STATE
+// Declare attribute list for Binary Input cluster (server).
+ZB_ZCL_DECLARE_BINARY_INPUT_ATTRIB_LIST(
+	binary_input_server_attr_list,
+	&dev_ctx.binary_input_attr.out_of_service,
+	&dev_ctx.binary_input_attr.present_value,
+	&dev_ctx.binary_input_attr.status_flags
+);
+#endif
+
+#ifdef APP_METRICS_CLUSTER
+// Declare attribute list for the manufacturer specific metrics cluster (server).
+ZB_ZCL_START_DECLARE_ATTRIB_LIST_CLUSTER_REVISION(app_metrics_server_attr_list, ZB_ZCL_APP_METRICS)
+#ifdef CONFIG_APP_LATENCY_PROBES
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_LATENCY_ID(LATENCY_STAGE_SETTLE),
+		dev_ctx.metrics_attr.latency[LATENCY_STAGE_SETTLE], ZB_ZCL_ATTR_TYPE_OCTET_STRING)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_LATENCY_ID(LATENCY_STAGE_DISPATCH),
+		dev_ctx.metrics_attr.latency[LATENCY_STAGE_DISPATCH], ZB_ZCL_ATTR_TYPE_OCTET_STRING)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_LATENCY_ID(LATENCY_STAGE_BUFFER),
+		dev_ctx.metrics_attr.latency[LATENCY_STAGE_BUFFER], ZB_ZCL_ATTR_TYPE_OCTET_STRING)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_LATENCY_ID(LATENCY_STAGE_AIR),
+		dev_ctx.metrics_attr.latency[LATENCY_STAGE_AIR], ZB_ZCL_ATTR_TYPE_OCTET_STRING)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_LATENCY_ID(LATENCY_STAGE_TOTAL),
+		dev_ctx.metrics_attr.latency[LATENCY_STAGE_TOTAL], ZB_ZCL_ATTR_TYPE_OCTET_STRING)
+#endif
+#ifdef CONFIG_APP_ENERGY_ACCOUNTING
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_ENERGY_EVENTS_ID(ENERGY_EVENT_TX),
+		&dev_ctx.metrics_attr.energy_events[ENERGY_EVENT_TX], ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_ENERGY_EVENTS_ID(ENERGY_EVENT_POLL),
+		&dev_ctx.metrics_attr.energy_events[ENERGY_EVENT_POLL], ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_ENERGY_EVENTS_ID(ENERGY_EVENT_SAADC),
+		&dev_ctx.metrics_attr.energy_events[ENERGY_EVENT_SAADC], ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_ENERGY_EVENTS_ID(ENERGY_EVENT_WAKEUP),
+		&dev_ctx.metrics_attr.energy_events[ENERGY_EVENT_WAKEUP], ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_LED_ON_TIME_ID,
+		&dev_ctx.metrics_attr.led_on_time_ms, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_CONSUMED_UAH_ID,
+		&dev_ctx.metrics_attr.consumed_uah, ZB_ZCL_ATTR_TYPE_U32)
+#endif
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_SAADC_CONVERSION_US_ID,
+		&dev_ctx.metrics_attr.saadc_conversion_us, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_SAADC_WORKQUEUE_US_ID,
+		&dev_ctx.metrics_attr.saadc_workqueue_us, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_POLL_INTERVAL_MS_ID,
+		&dev_ctx.metrics_attr.poll_interval_ms, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_POLLS_ESTIMATE_ID,
+		&dev_ctx.metrics_attr.polls_estimate, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_FAST_POLLS_ESTIMATE_ID,
+		&dev_ctx.metrics_attr.fast_polls_estimate, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_SPI_FLASH_POWER_DOWN_US_ID,
+		&dev_ctx.metrics_attr.spi_flash_power_down_us, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_BUTTON_OVERFLOWS_ID,
+		&dev_ctx.metrics_attr.button_overflows, ZB_ZCL_ATTR_TYPE_U32)
+#ifdef CONFIG_APP_RELIABLE_SEND
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_CMDS_SENT_ID,
+		&dev_ctx.metrics_attr.cmds_sent, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_CMDS_DELIVERED_ID,
+		&dev_ctx.metrics_attr.cmds_delivered, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_CMDS_FAILED_ID,
+		&dev_ctx.metrics_attr.cmds_failed, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_CMD_RETRIES_ID,
+		&dev_ctx.metrics_attr.cmd_retries, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_DELIVERY_MS_AVG_ID,
+		&dev_ctx.metrics_attr.delivery_ms_avg, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_DELIVERY_MS_MAX_ID,
+		&dev_ctx.metrics_attr.delivery_ms_max, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_CMDS_UNTRACKED_ID,
+		&dev_ctx.metrics_attr.cmds_untracked, ZB_ZCL_ATTR_TYPE_U32)
+#endif
+#ifdef CONFIG_APP_FAST_REJOIN
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_JOIN_MS_ID,
+		&dev_ctx.metrics_attr.join_ms, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_JOIN_RADIO_MS_ID,
+		&dev_ctx.metrics_attr.join_radio_ms, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_CACHED_JOINS_ID,
+		&dev_ctx.metrics_attr.cached_joins, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_CACHED_FAILURES_ID,
+		&dev_ctx.metrics_attr.cached_failures, ZB_ZCL_ATTR_TYPE_U32)
+#endif
+#ifdef CONFIG_APP_STACK_WATERMARKS
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_STACK_MIN_UNUSED_ID,
+		&dev_ctx.metrics_attr.stack_min_unused, ZB_ZCL_ATTR_TYPE_U32)
+#endif
+#ifdef CONFIG_APP_BUF_PRESSURE
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_BUF_WAITING_MAX_ID,
+		&dev_ctx.metrics_attr.buf_waiting_max, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_BUF_IN_USE_MAX_ID,
+		&dev_ctx.metrics_attr.buf_in_use_max, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_BUF_FAILURES_ID,
+		&dev_ctx.metrics_attr.buf_failures, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_CMDS_COALESCED_ID,
+		&dev_ctx.metrics_attr.cmds_coalesced, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_CMDS_DROPPED_ID,
+		&dev_ctx.metrics_attr.cmds_dropped, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_BUF_MEMORY_LOW_ID,
+		&dev_ctx.metrics_attr.buf_memory_low, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_BUF_OOM_ID,
+		&dev_ctx.metrics_attr.buf_oom, ZB_ZCL_ATTR_TYPE_U32)
+#endif
+#ifdef CONFIG_APP_OTA
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_OTA_IMAGE_BYTES_ID,
+		&dev_ctx.metrics_attr.ota_image_bytes, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_OTA_BYTES_ID,
+		&dev_ctx.metrics_attr.ota_bytes, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_OTA_TRANSFER_MS_ID,
+		&dev_ctx.metrics_attr.ota_transfer_ms, ZB_ZCL_ATTR_TYPE_U32)
+	ZB_ZCL_SET_APP_METRICS_ATTR_DESC(ZB_ZCL_ATTR_APP_METRICS_OTA_BYTES_PER_S_ID,
+		&dev_ctx.metrics_attr.ota_bytes_per_s, ZB_ZCL_ATTR_TYPE_U32)
+#endif
+ZB_ZCL_FINISH_DECLARE_ATTRIB_LIST;
+#endif
+
+// Declare cluster list for four input device.
+ZB_DECLARE_FOUR_INPUT_CLUSTER_LIST
+(
+	four_input_clusters,
+	basic_server_attr_list,
+	identify_client_attr_list,
+	identify_server_attr_list,
+	on_off_client_attr_list,
+	power_config_server_attr_list,
+	alarms_server_attr_list,
+	diagnostics_server_attr_list,
+	binary_input_server_attr_list,
+	app_metrics_server_attr_list
+);
+
+// Declare endpoint for four input device.
+ZB_DECLARE_FOUR_INPUT_EP
+(
+	four_input_ep,
+	SOURCE_ENDPOINT,
+	four_input_clusters
+);
+
+#ifdef CONFIG_APP_OTA
+// the ota upgrade client is an endpoint of its own, declared by the fota library
+extern zb_af_endpoint_desc_t zigbee_fota_client_ep;
+
+// Declare application's device context (list of registered endpoints) for four input device.
+ZBOSS_DECLARE_DEVICE_CTX_2_EP
+(
+	four_input_ctx,
+	zigbee_fota_client_ep,
+	four_input_ep
+);
+#else
+// Declare application's device context (list of registered endpoints) for four input device.
+ZBOSS_DECLARE_DEVICE_CTX_1_EP
+(
+	four_input_ctx, 
+	four_input_ep
+);
+#endif
+
+// alarm for taking an ADC reading every 6 hours
+struct k_timer read_battery_voltage_timer;
+K_WORK_DEFINE (read_battery_voltage_work, read_battery_voltage_work_handler);
+
+// attributes reported to the coordinator, with the default intervals the coordinator can
+// configure others for. values set with reporting_set () are reported on change, every
+// changed attribute of a cluster in one report attributes frame.
+static const struct reporting_attr report_table[] = {
+	// technically not reportable, so no periodic reports
+	{ ZB_ZCL_CLUSTER_ID_POWER_CONFIG, ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_ID,              RPT_MIN, 0,       0 },
+	{ ZB_ZCL_CLUSTER_ID_POWER_CONFIG, ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_REMAINING_ID, RPT_MIN, RPT_MAX, 0 },
+	{ ZB_ZCL_CLUSTER_ID_POWER_CONFIG, ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_ALARM_STATE_ID,          RPT_MIN, RPT_MAX, 0 },
+#ifdef CONFIG_APP_CONTACT_STATE
+	// contact state on every change, so the coordinator's cache always holds the current state
+	{ ZB_ZCL_CLUSTER_ID_BINARY_INPUT, ZB_ZCL_ATTR_BINARY_INPUT_PRESENT_VALUE_ID,                0,       0,       0 },
+#endif
+};
+
+BUILD_ASSERT(ARRAY_SIZE(report_table) <= ZB_FOUR_INPUT_REPORT_ATTR_COUNT,
+             "more reported attributes than reporting slots");
+
+BUILD_ASSERT(ARRAY_SIZE(sleepy_input_dispatch) < 32, "the button handler masks at most 31 inputs");
+
+
+//---------------------------------------------------------------------------------------------
+// main
+//
+
+int main (void)
+{
+	LOG_INF ("Starting Four Input Device");
+
+	// initialize
+	configure_gpio ();
+	register_factory_reset_button (IDENTIFY_BUTTON);
+	zigbee_erase_persistent_storage (ERASE_PERSISTENT_CONFIG);
+	zb_set_ed_timeout (ED_AGING_TIMEOUT_64MIN);
+    zb_set_keepalive_timeout (ZB_MILLISECONDS_TO_BEACON_INTERVAL(3600*1000));
+    
+#if DT_NODE_EXISTS (DT_NODELABEL (sw_spi_cs_n))
+	// place spi flash in power down mode
+	spi_flash_power_down ();
+	LOG_INF ("spi flash powered down in %u us", spi_flash_power_down_us ());
+#endif
+
+	// send things to endpoint 1 on the coordinator
+	dest_ctx.short_addr = DEST_SHORT_ADDR;
+	dest_ctx.endpoint = DEST_ENDPOINT;
+
+	// configure for lowest power
+	zigbee_configure_sleepy_behavior (true);
+	power_down_unused_ram ();
+
+	// register switch device context (endpoints)
+	ZB_AF_REGISTER_DEVICE_CTX (&four_input_ctx);
+
+	// initialize application clusters
+	app_clusters_attr_init ();
+	reporting_init (SOURCE_ENDPOINT, report_table, ARRAY_SIZE(report_table));
+	battery_alarm_init (SOURCE_ENDPOINT, DEST_SHORT_ADDR, DEST_ENDPOINT);
+
+	// find events held back before a reboot, replayed after joining
+	event_log_init (replay_event);
+#ifdef CONFIG_APP_GESTURES
+	gesture_init (gesture_handler);
+#endif
+	delivery_init (light_switch_send_on_off);
+	trace_init ();
+	buf_pressure_init (send_input_command);
+
+	// register handlers to identify notifications
+	ZB_AF_SET_IDENTIFY_NOTIFICATION_HANDLER(SOURCE_ENDPOINT, identify_cb);
+	ZB_AF_SET_ENDPOINT_HANDLER(SOURCE_ENDPOINT, endpoint_handler);
+
+#ifdef CONFIG_APP_OTA
+	// ota upgrade client; confirms this image to mcuboot
+	int ota_err = ota_init (ota_evt_handler);
+	if (ota_err != 0) {
+		LOG_ERR ("ota client not started: %d", ota_err);
+	}
+	ZB_ZCL_REGISTER_DEVICE_CB (zcl_device_cb);
+#endif
+
+	// initialize read battery voltage timer and the saadc it triggers
+	k_timer_init (&read_battery_voltage_timer, read_battery_voltage_cb, NULL);
+	battery_init ();
+
+	// scan the channel of the network joined last before every other channel
+	fast_rejoin_init ();
+
+	// start Zigbee default thread
+	zigbee_enable ();
+
+	LOG_INF ("Four Input Device started");
+
+	// suspend main thread
+	while (1) {
+		k_sleep (K_FOREVER);
+	}
+}
+
+
+//---------------------------------------------------------------------------------------------
+// stack high-water marks
+//
+
+#ifdef CONFIG_APP_STACK_WATERMARKS
+static void log_stack_watermark (const char *name, size_t size, size_t unused)
+{
+	LOG_INF ("stack %s: %u of %u bytes used", name, (unsigned)(size - unused), (unsigned)size);
+}
+#else
+#define log_stack_watermark NULL
+#endif
+
+
+//---------------------------------------------------------------------------------------------
+// zigbee stack event handler
+//
+
+void zboss_signal_handler(zb_bufid_t bufid)
+{
+	static bool lastJoin = false;
+
+	zb_zdo_app_signal_hdr_t *sig_hndler = NULL;
+	zb_zdo_app_signal_type_t sig = zb_get_app_signal(bufid, &sig_hndler);
+	zb_ret_t status = ZB_GET_APP_SIGNAL_STATUS(bufid);
+
+	trace_cb_enter (TRACE_CB_SIGNAL_HANDLER);
+	trace_record (TRACE_SIGNAL, 0, sig);
+
+	// the stack asks to sleep once per wake-up; hand the trace to the host before sleeping
+	if (sig == ZB_COMMON_SIGNAL_CAN_SLEEP) {
+		energy_count (ENERGY_EVENT_WAKEUP);
+		trace_flush ();
+	}
+
+	// Update network status LED.
+	// zigbee_led_status_update(bufid, ZIGBEE_NETWORK_STATE_LED);
+
+	// the ota client looks at the signals first
+	ota_signal (bufid);
+
+	// the stack gave up on the parent after polls or frames to it went unanswered
+	bool parentLost = (sig == ZB_NLME_STATUS_INDICATION) &&
+	    (ZB_ZDO_SIGNAL_GET_PARAMS(sig_hndler, zb_zdo_signal_nlme_status_indication_params_t)->nlme_status.status ==
+	     ZB_NWK_COMMAND_STATUS_PARENT_LINK_FAILURE);
+	if (parentLost) {
+		diagnostics_parent_link_failure ();
+	}
+
+	// Call default signal handler until there's a reason to check for different signals
+	// the default handler evens calls zb_sleep_now for us. a lost parent is rejoined on the
+	// cached channel instead of the default handler's rejoin over every channel.
+	int64_t handler_ms = k_uptime_get ();
+	if (!parentLost || !fast_rejoin_start ()) {
+		ZB_ERROR_CHECK(zigbee_default_signal_handler(bufid));
+	}
+
+	// sleeping while not joined keeps the radio off between scans
+	if ((sig == ZB_COMMON_SIGNAL_CAN_SLEEP) && !ZB_JOINED ()) {
+		fast_rejoin_slept ((uint32_t)(k_uptime_get () - handler_ms));
+	}
+
+	// a leave for good ends the cached network; a new one may be on any channel. a leave with
+	// rejoin keeps it, as the rejoin finds the network on the cached channel.
+	if ((sig == ZB_ZDO_SIGNAL_LEAVE) &&
+	    (ZB_ZDO_SIGNAL_GET_PARAMS(sig_hndler, zb_zdo_signal_leave_params_t)->leave_type ==
+	     ZB_NWK_LEAVE_TYPE_RESET)) {
+		fast_rejoin_forget ();
+	}
+
+	// free buffer if it's allocated
+	if (bufid) {
+		zb_buf_free(bufid);
+	}
+
+	// once joined, poll fast for the coordinator's interview and back off to an hour, replay
+	// the input events held back while not joined, and read the battery voltage every few hours.
+	// if using a sparkfun board with a spi flash chip, drop the flash chip 
+	// into power down mode again just in case missed it the first time.
+	bool thisJoin = ZB_JOINED();
+	if ((lastJoin == false) && (thisJoin == true)) {
+		LOG_INF ("joined network!");
+		led_set_off (ZIGBEE_NETWORK_STATE_LED);
+		fast_rejoin_joined ();
+		diagnostics_joined ();
+#ifdef CONFIG_APP_FAST_REJOIN
+		LOG_INF ("join took %u ms, radio on %u ms", fast_rejoin_join_ms (), fast_rejoin_radio_ms ());
+#endif
+		poll_policy_start ();
+		reporting_configure (DEST_SHORT_ADDR, DEST_ENDPOINT);
+#ifdef CONFIG_APP_CONTACT_STATE
+		update_contact_state (dev_ctx.binary_input_attr.present_value);
+#endif
+		event_log_replay_start ();
+		k_timer_start(&read_battery_voltage_timer, READ_BATTERY_VOLTAGE_INITIAL_DELAY, READ_BATTERY_VOLTAGE_TIMER_PERIOD);
+		spi_flash_power_down ();
+		// stack use from boot through joining, to size the stacks against
+		stack_watermark_scan (log_stack_watermark);
+	} else if ((lastJoin == true) && (thisJoin == false)) {
+		LOG_INF ("left network!");
+		// no longer joined, turn on network state led and stop reading battery voltage. input
+		// events are held back from now on.
+		led_set_on (ZIGBEE_NETWORK_STATE_LED);
+		fast_rejoin_lost ();
+		k_timer_stop(&read_battery_voltage_timer);
+		poll_policy_stop ();
+		event_log_replay_stop ();
+	}
+	lastJoin = thisJoin;
+
+	trace_cb_exit (TRACE_CB_SIGNAL_HANDLER);
+}
+
+
+//---------------------------------------------------------------------------------------------
+// configure LEDs and buttons
+//
+
+static void configure_gpio (void)
+{
+	// every led starts off; turn the network state led on until network is joined
+	led_init ();
+	led_set_on (ZIGBEE_NETWORK_STATE_LED);
+
+	buttons_init (button_handler);
+}
+
+
+//---------------------------------------------------------------------------------------------
+// set default values of attributes in the application's clusters
+//
+
+static void app_clusters_attr_init (void)
+{
+	// Basic cluster attributes data.
+	dev_ctx.basic_attr.zcl_version   = ZB_ZCL_VERSION;
+	dev_ctx.basic_attr.power_source  = ZB_ZCL_BASIC_POWER_SOURCE_UNKNOWN;
+    dev_ctx.basic_attr.power_source  = FOUR_INPUT_INIT_BASIC_POWER_SOURCE;
+    dev_ctx.basic_attr.stack_version = FOUR_INPUT_INIT_BASIC_STACK_VERSION;
+    dev_ctx.basic_attr.hw_version    = FOUR_INPUT_INIT_BASIC_HW_VERSION;
+
+    // Use ZB_ZCL_SET_STRING_VAL to set strings, because the first byte should
+    // contain string length without trailing zero.
+    //
+    // For example "test" string wil be encoded as:
+    //   [(0x4), 't', 'e', 's', 't']
+
+    ZB_ZCL_SET_STRING_VAL(dev_ctx.basic_attr.mf_name,
+                          FOUR_INPUT_INIT_BASIC_MANUF_NAME,
+                          ZB_ZCL_STRING_CONST_SIZE(FOUR_INPUT_INIT_BASIC_MANUF_NAME));
+
+    ZB_ZCL_SET_STRING_VAL(dev_ctx.basic_attr.model_id,
+                          FOUR_INPUT_INIT_BASIC_MODEL_ID,
+                          ZB_ZCL_STRING_CONST_SIZE(FOUR_INPUT_INIT_BASIC_MODEL_ID));
+
+    ZB_ZCL_SET_STRING_VAL(dev_ctx.basic_attr.date_code,
+                          FOUR_INPUT_INIT_BASIC_DATE_CODE,
+                          ZB_ZCL_STRING_CONST_SIZE(FOUR_INPUT_INIT_BASIC_DATE_CODE));
+
+
+    ZB_ZCL_SET_STRING_VAL(dev_ctx.basic_attr.location_id,
+                          FOUR_INPUT_INIT_BASIC_LOCATION_DESC,
+                          ZB_ZCL_STRING_CONST_SIZE(FOUR_INPUT_INIT_BASIC_LOCATION_DESC));
+
+
+    dev_ctx.basic_attr.ph_env = FOUR_INPUT_INIT_BASIC_PH_ENV;
+
+	// Identify cluster attributes data.
+	dev_ctx.identify_attr.identify_time = ZB_ZCL_IDENTIFY_IDENTIFY_TIME_DEFAULT_VALUE;
+
+	// Power config attributes data.
+	dev_ctx.power_attr.voltage               = ZB_ZCL_POWER_CONFIG_BATTERY_VOLTAGE_INVALID;
+	dev_ctx.power_attr.size                  = ZB_ZCL_POWER_CONFIG_BATTERY_SIZE_OTHER;
+	dev_ctx.power_attr.quantity              = 1;
+	dev_ctx.power_attr.rated_voltage         = 30;
+	dev_ctx.power_attr.alarm_mask            = 0x0f;
+	dev_ctx.power_attr.voltage_min_threshold = 20;
+	dev_ctx.power_attr.percent_remaining     = ZB_ZCL_POWER_CONFIG_BATTERY_REMAINING_UNKNOWN;
+	dev_ctx.power_attr.voltage_threshold_1   = 22;
+	dev_ctx.power_attr.voltage_threshold_2   = 24;
+	dev_ctx.power_attr.voltage_threshold_3   = 26;
+	dev_ctx.power_attr.percent_min_threshold = 2*10;
+	dev_ctx.power_attr.percent_threshold_1   = 2*15;
+	dev_ctx.power_attr.percent_threshold_2   = 2*20;
+	dev_ctx.power_attr.percent_threshold_3   = 2*25;
+	dev_ctx.power_attr.alarm_state           = 0x00000000;
+
+	// Diagnostics attributes data, counted from boot.
+	diagnostics_init (&dev_ctx.diagnostics_attr);
+
+#ifdef CONFIG_APP_CONTACT_STATE
+	// Binary input attributes data, the contact state read at boot.
+	uint32_t button_state;
+	dk_read_buttons (&button_state, NULL);
+	dev_ctx.binary_input_attr.out_of_service = ZB_FALSE;
+	dev_ctx.binary_input_attr.present_value  = (button_state & CONTACT_INPUT) ? ZB_TRUE : ZB_FALSE;
+	dev_ctx.binary_input_attr.status_flags   = ZB_ZCL_BINARY_INPUT_STATUS_FLAG_NORMAL;
+#endif
+
+#ifdef APP_METRICS_CLUSTER
+	// Metrics cluster attributes data.
+	update_metrics_attrs ();
+#endif
+}
+
+
+#ifdef CONFIG_APP_CONTACT_STATE
+//---------------------------------------------------------------------------------------------
+// update the contact state attribute
+//
+// contact_open   ZB_TRUE while the magnet is away from the sensor.
+//
+// While joined the change is reported at once; otherwise only the storage is written and the
+// current state is reported after the next join.
+//
+
+static void update_contact_state (zb_bool_t contact_open)
+{
+	if (ZB_JOINED ()) {
+		reporting_set (ZB_ZCL_CLUSTER_ID_BINARY_INPUT,
+		               ZB_ZCL_ATTR_BINARY_INPUT_PRESENT_VALUE_ID,
+		               &contact_open);
+	} else {
+		dev_ctx.binary_input_attr.present_value = contact_open;
+	}
+}
+#endif
+
+
+#ifdef APP_METRICS_CLUSTER
+//---------------------------------------------------------------------------------------------
+// copy the current measurements into the metrics cluster attributes
+//
+
+static void update_metrics_attrs (void)
+{
+#ifdef CONFIG_APP_LATENCY_PROBES
+	for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+		latency_encode (stage, dev_ctx.metrics_attr.latency[stage]);
+	}
+#endif
+#ifdef CONFIG_APP_ENERGY_ACCOUNTING
+	energy_update ();
+	for (int event = 0; event < ENERGY_EVENT_COUNT; event++) {
+		dev_ctx.metrics_attr.energy_events[event] = energy_events (event);
+	}
+	dev_ctx.metrics_attr.led_on_time_ms = energy_led_on_time_ms ();
+	dev_ctx.metrics_attr.consumed_uah = energy_consumed_uah ();
+#endif
+	dev_ctx.metrics_attr.saadc_conversion_us = battery_conversion_us ();
+	dev_ctx.metrics_attr.saadc_workqueue_us = battery_caller_us ();
+	dev_ctx.metrics_attr.poll_interval_ms = poll_policy_interval_ms ();
+	dev_ctx.metrics_attr.polls_estimate = poll_policy_polls_estimate ();
+	dev_ctx.metrics_attr.fast_polls_estimate = poll_policy_fast_polls_estimate ();
+	dev_ctx.metrics_attr.spi_flash_power_down_us = spi_flash_power_down_us ();
+	dev_ctx.metrics_attr.button_overflows = buttons_overflow_count ();
+#ifdef CONFIG_APP_RELIABLE_SEND
+	const struct delivery_stats *st = delivery_stats (dest_ctx.endpoint);
+	if (st != NULL) {
+		dev_ctx.metrics_attr.cmds_sent = st->sent;
+		dev_ctx.metrics_attr.cmds_delivered = st->delivered;
+		dev_ctx.metrics_attr.cmds_failed = st->failed;
+		dev_ctx.metrics_attr.cmd_retries = st->retries;
+		dev_ctx.metrics_attr.delivery_ms_avg = st->delivered ? (st->latency_ms_sum / st->delivered) : 0;
+		dev_ctx.metrics_attr.delivery_ms_max = st->latency_ms_max;
+		dev_ctx.metrics_attr.cmds_untracked = st->untracked;
+	}
+#endif
+#ifdef CONFIG_APP_FAST_REJOIN
+	dev_ctx.metrics_attr.join_ms = fast_rejoin_join_ms ();
+	dev_ctx.metrics_attr.join_radio_ms = fast_rejoin_radio_ms ();
+	dev_ctx.metrics_attr.cached_joins = fast_rejoin_cached_joins ();
+	dev_ctx.metrics_attr.cached_failures = fast_rejoin_cached_failures ();
+#endif
+#ifdef CONFIG_APP_STACK_WATERMARKS
+	dev_ctx.metrics_attr.stack_min_unused = stack_watermark_min_unused ();
+#endif
+#ifdef CONFIG_APP_BUF_PRESSURE
+	const struct buf_pressure_stats *bp = buf_pressure_stats ();
+	dev_ctx.metrics_attr.buf_waiting_max = bp->waiting_max;
+	dev_ctx.metrics_attr.buf_in_use_max = bp->in_use_max;
+	dev_ctx.metrics_attr.buf_failures = bp->failures;
+	dev_ctx.metrics_attr.cmds_coalesced = bp->coalesced;
+	dev_ctx.metrics_attr.cmds_dropped = bp->dropped;
+	dev_ctx.metrics_attr.buf_memory_low = bp->memory_low;
+	dev_ctx.metrics_attr.buf_oom = bp->oom;
+#endif
+#ifdef CONFIG_APP_OTA
+	const struct ota_stats *ota = ota_stats ();
+	dev_ctx.metrics_attr.ota_image_bytes = ota->image_bytes;
+	dev_ctx.metrics_attr.ota_bytes = ota->bytes;
+	dev_ctx.metrics_attr.ota_transfer_ms = ota->transfer_ms;
+	dev_ctx.metrics_attr.ota_bytes_per_s = ota->bytes_per_s;
+#endif
+}
+#endif
+
+
+//---------------------------------------------------------------------------------------------
+// endpoint handler
+//
+// bufid    Buffer holding the zb_zcl_parsed_hdr_t of a zcl frame to the endpoint.
+//
+// Sees every zcl frame to the endpoint before the stack, which answers all of them. A read of
+// the metrics cluster measures the thread stacks first, too slow to do on every input event,
+// and refreshes the attributes. Configure reporting commands go to the reporting module.
+//
+
+static zb_uint8_t endpoint_handler (zb_bufid_t bufid)
+{
+	zb_zcl_parsed_hdr_t *cmd_info = ZB_BUF_GET_PARAM(bufid, zb_zcl_parsed_hdr_t);
+
+#ifdef APP_METRICS_CLUSTER
+	if ((cmd_info->cluster_id == ZB_ZCL_CLUSTER_ID_APP_METRICS) && cmd_info->is_common_command &&
+	    (cmd_info->cmd_id == ZB_ZCL_CMD_READ_ATTRIB)) {
+		stack_watermark_scan (NULL);
+		update_metrics_attrs ();
+	}
+#endif
+
+	reporting_command (cmd_info);
+	return ZB_FALSE;
+}
+
+
+//---------------------------------------------------------------------------------------------
+// button event handler
+//
+// runs in the zboss thread; buttons.c queues edges from the gpio interrupt and drains them here.
+//
+
+static void button_handler (uint32_t button_state, uint32_t has_changed)
+{
+	zb_uint16_t cmd_queue[BUTTON_EVENT_QUEUE_SIZE];
+	zb_uint8_t input_queue[BUTTON_EVENT_QUEUE_SIZE];
+	int cmd_count = 0;
+
+	static uint32_t last_overflows = 0;
+
+	LOG_INF ("button_handler");
+
+	// an input change is often followed by traffic from the coordinator, so poll fast again
+	poll_policy_kick ();
+
+	// report edges lost between the gpio interrupt and the zboss thread
+	uint32_t overflows = buttons_overflow_count ();
+	if (overflows != last_overflows) {
+		LOG_WRN ("button event ring overflowed %u times", overflows);
+		last_overflows = overflows;
+	}
+
+	// inform default signal handler about user input at the device
+	user_input_indicate ();
+
+	// check for start of factory reset
+	check_factory_reset_button (button_state, has_changed);
+
+#ifdef CONFIG_APP_CONTACT_STATE
+	// the contact state attribute follows the input whether or not the commands are held back
+	if (has_changed & CONTACT_INPUT) {
+		update_contact_state ((button_state & CONTACT_INPUT) ? ZB_TRUE : ZB_FALSE);
+	}
+#endif
+
+	// walk only the inputs that changed, lowest bit first, so simultaneous edges are not lost.
+	// each one is a single lookup in the dispatch table, however many inputs there are.
+	uint32_t edges = has_changed & BIT_MASK(ARRAY_SIZE(sleepy_input_dispatch));
+	while (edges) {
+		uint32_t bit = u32_count_trailing_zeros (edges);
+		uint32_t mask = BIT(bit);
+		bool pressed = (button_state & mask) != 0;
+
+		// clear lowest set bit
+		edges &= edges - 1;
+
+		if (mask == IDENTIFY_BUTTON) {
+			// identify button released: if not factory reset, enter identify mode
+			if (!pressed && !was_factory_reset_done ()) {
+				ZB_SCHEDULE_APP_CALLBACK (start_identifying, 0);
+			}
+			continue;
+		}
+
+#ifdef CONFIG_APP_GESTURES
+		// the gesture engine sends one command per gesture from gesture_handler
+		gesture_edge (bit, pressed, buttons_event_cycles ());
+#else
+		const struct sleepy_input_cmds *cmds = &sleepy_input_dispatch[bit];
+		zb_uint16_t cmd_id = pressed ? cmds->press : cmds->release;
+
+		if (cmd_id == SLEEPY_INPUT_NO_CMD) {
+			continue;
+		}
+
+		if (cmd_count < BUTTON_EVENT_QUEUE_SIZE) {
+			input_queue[cmd_count] = bit;
+			cmd_queue[cmd_count++] = cmd_id;
+		} else {
+			LOG_WRN ("button event queue full, dropping command %d", cmd_id);
+		}
+#endif
+	}
+
+	// send one command per queued edge, in the order the edges were decoded
+	for (int i = 0; i < cmd_count; i++) {
+		dispatch_command (input_queue[i], cmd_queue[i], buttons_event_cycles ());
+	}
+}
+
+
+#ifdef CONFIG_APP_GESTURES
+//---------------------------------------------------------------------------------------------
+// gesture event handler
+//
+// input        Input bit position.
+// gesture      Gesture recognised on the input.
+// edge_cycles  k_cycle_get_32 () timestamp of the edge or timeout that completed the gesture.
+//
+// A single press sends the button's on/off command so direct bindings keep working, every
+// other gesture its own manufacturer specific command id.
+//
+
+static void gesture_handler (uint8_t input, enum gesture gesture, uint32_t edge_cycles)
+{
+	zb_uint16_t cmd_id;
+
+	LOG_INF ("input %d gesture %d", input, gesture);
+
+	cmd_id = (gesture == GESTURE_SINGLE) ? sleepy_input_dispatch[input].press : GESTURE_CMD(input, gesture);
+	dispatch_command (input, cmd_id, edge_cycles);
+}
+#endif
+
+
+//---------------------------------------------------------------------------------------------
+// send a command for an input, or hold it back
+//
+// input        Input bit position.
+// cmd_id       ZCL command id.
+// edge_cycles  k_cycle_get_32 () timestamp of the edge the command is for.
+//
+// While not joined, or while earlier events are still waiting to be replayed, the command is
+// held back with the uptime of the edge so none are lost or reordered. While the stack is
+// short of buffers, buf_pressure holds it back instead and sends it once buffers come back.
+// A command that gets neither an event stamp nor a buffer is held back like one sent while
+// not joined, and replayed once earlier frames are acked or given up.
+//
+
+static void dispatch_command (zb_uint8_t input, zb_uint16_t cmd_id, uint32_t edge_cycles)
+{
+	zb_ret_t zb_err_code;
+	uint32_t edge_ms = k_uptime_get_32 () - k_cyc_to_ms_floor32 (k_cycle_get_32 () - edge_cycles);
+
+	if (!ZB_JOINED () || event_log_pending ()) {
+		event_log_push (input, cmd_id, edge_ms);
+		return;
+	}
+
+	if (buf_pressure_hold (input, cmd_id, edge_cycles)) {
+		return;
+	}
+
+	zb_err_code = send_input_command (input, cmd_id, edge_cycles);
+
+	// a refused request makes the pressure high, so the command is held for later
+	if ((zb_err_code != RET_OK) && buf_pressure_hold (input, cmd_id, edge_cycles)) {
+		return;
+	}
+
+	if (zb_err_code != RET_OK) {
+		LOG_WRN ("no stamp or buffer for command %d, holding it back", cmd_id);
+		event_log_push (input, cmd_id, edge_ms);
+		event_log_replay_start ();
+	}
+}
+
+
+//---------------------------------------------------------------------------------------------
+// send the command for an input edge
+//
+// input        Input bit position.
+// cmd_id       ZCL command id.
+// edge_cycles  k_cycle_get_32 () timestamp of the edge the command is for.
+//
+
+static zb_ret_t send_input_command (zb_uint8_t input, zb_uint16_t cmd_id, uint32_t edge_cycles)
+{
+	zb_uint16_t param;
+	zb_ret_t zb_err_code = send_event (input, cmd_id,
+	                                   k_cyc_to_ms_floor32 (k_cycle_get_32 () - edge_cycles), &param);
+
+	if (zb_err_code == RET_OK) {
+		latency_cmd_queued (param, edge_cycles);
+	}
+
+	return zb_err_code;
+}
+
+
+//---------------------------------------------------------------------------------------------
+// number an input event and get a buffer for its command
+//
+// input    Input bit position.
+// cmd_id   ZCL command id.
+// age_ms   Time since the edge in ms, negative when the edge was before the last reboot.
+// param    Set to the frame parameter the buffer was requested with.
+//
+
+static zb_ret_t send_event (zb_uint8_t input, zb_uint16_t cmd_id, int64_t age_ms, zb_uint16_t *param)
+{
+	zb_ret_t zb_err_code = event_stamp_add (input, cmd_id, age_ms, param);
+
+	if (zb_err_code != RET_OK) {
+		return zb_err_code;
+	}
+
+	zb_err_code = send_command (*param);
+	if (zb_err_code != RET_OK) {
+		event_stamp_drop (*param);
+	}
+
+	return zb_err_code;
+}
+
+
+//---------------------------------------------------------------------------------------------
+// get a buffer for an on off command to the coordinator
+//
+// param    Frame parameter from event_stamp_add.
+//
+// With reliable send, a command is sent again until its aps ack arrives or the retries run out.
+//
+
+static zb_ret_t send_command (zb_uint16_t param)
+{
+#ifdef CONFIG_APP_RELIABLE_SEND
+	return delivery_send (dest_ctx.endpoint, param);
+#else
+	return buf_pressure_get (light_switch_send_on_off, param);
+#endif
+}
+
+
+//---------------------------------------------------------------------------------------------
+// send light switch on off command
+//
+// bufid    Non-zero reference to Zigbee stack buffer that will be used to construct on/off request.
+// param    Frame parameter from event_stamp_add.
+//
+// With event stamps the command goes out as the manufacturer specific event command, which
+// carries the boot and sequence number of the event and its age now, so retries report the
+// true age too and the coordinator can drop the ones that arrive twice. Without them a
+// command id marked SLEEPY_INPUT_CMD_MANUF goes out as a manufacturer specific command with
+// no payload, every other one as the standard on/off command.
+//
+
+static void light_switch_send_on_off (zb_bufid_t bufid, zb_uint16_t param)
+{
+	zb_uint8_t cmd_id = EVENT_STAMP_CMD(param);
+	const struct event_stamp *stamp = event_stamp_get (param);
+
+	LOG_INF("Send ON/OFF command: %d", cmd_id);
+
+	trace_cb_enter (TRACE_CB_SEND_ON_OFF);
+	trace_record (TRACE_TX, TRACE_TX_ON_OFF, cmd_id);
+	buf_pressure_granted ();
+	latency_cmd_sending (param, bufid);
+	energy_count (ENERGY_EVENT_TX);
+
+#ifdef APP_METRICS_CLUSTER
+	update_metrics_attrs ();
+#endif
+
+	if ((stamp != NULL) || (param & SLEEPY_INPUT_CMD_MANUF)) {
+		zb_uint8_t *ptr = ZB_ZCL_START_PACKET(bufid);
+
+		ZB_ZCL_CONSTRUCT_SPECIFIC_COMMAND_REQ_FRAME_CONTROL_A(ptr, ZB_ZCL_FRAME_DIRECTION_TO_SRV,
+		                                                      ZB_ZCL_MANUFACTURER_SPECIFIC,
+		                                                      ZB_ZCL_DISABLE_DEFAULT_RESPONSE);
+		if (stamp != NULL) {
+			event_stamp_sent (param, bufid);
+			ZB_ZCL_CONSTRUCT_COMMAND_HEADER_EXT(ptr, ZB_ZCL_GET_SEQ_NUM(), ZB_ZCL_MANUFACTURER_SPECIFIC,
+			                                    APP_MANUF_CODE, ZB_ZCL_CMD_ON_OFF_APP_EVENT_ID);
+			ZB_ZCL_PACKET_PUT_DATA8(ptr, cmd_id);
+			ZB_ZCL_PACKET_PUT_DATA8(ptr, stamp->input);
+			ZB_ZCL_PACKET_PUT_DATA16_VAL(ptr, event_log_boot ());
+			ZB_ZCL_PACKET_PUT_DATA32_VAL(ptr, stamp->seq);
+			ZB_ZCL_PACKET_PUT_DATA32_VAL(ptr, event_stamp_age_ms (stamp));
+		} else {
+			ZB_ZCL_CONSTRUCT_COMMAND_HEADER_EXT(ptr, ZB_ZCL_GET_SEQ_NUM(), ZB_ZCL_MANUFACTURER_SPECIFIC,
+			                                    APP_MANUF_CODE, cmd_id);
+		}
+		ZB_ZCL_FINISH_PACKET(bufid, ptr)
+		ZB_ZCL_SEND_COMMAND_SHORT(bufid, dest_ctx.short_addr, ZB_APS_ADDR_MODE_16_ENDP_PRESENT,
+		                          dest_ctx.endpoint, SOURCE_ENDPOINT, ZB_AF_HA_PROFILE_ID,
+		                          ZB_ZCL_CLUSTER_ID_ON_OFF, LIGHT_SWITCH_SEND_CB);
+		trace_cb_exit (TRACE_CB_SEND_ON_OFF);
+		return;
+	}
+
+	ZB_ZCL_ON_OFF_SEND_REQ(bufid,
+			       dest_ctx.short_addr,
+			       ZB_APS_ADDR_MODE_16_ENDP_PRESENT,
+			       dest_ctx.endpoint,
+			       SOURCE_ENDPOINT,
+			       ZB_AF_HA_PROFILE_ID,
+			       ZB_ZCL_DISABLE_DEFAULT_RESPONSE,
+			       cmd_id,
+			       LIGHT_SWITCH_SEND_CB);
+	trace_cb_exit (TRACE_CB_SEND_ON_OFF);
+}
+
+
+//---------------------------------------------------------------------------------------------
+// send an event held back while the device was not joined
+//
+// entry    Event with the uptime of its edge.
+//
+// Without event stamps the on/off command has no field for the time of the edge, so the age
+// is only logged.
+//
+
+static int replay_event (const struct event_log_entry *entry)
+{
+	int64_t age_ms = event_log_age_ms (entry);
+	zb_uint16_t param;
+
+	if (age_ms < 0) {
+		LOG_INF ("Replay input %d from before reboot", entry->input);
+	} else {
+		LOG_INF ("Replay input %d from %lld ms ago", entry->input, age_ms);
+	}
+
+	if (buf_pressure_high () || (send_event (entry->input, entry->cmd_id, age_ms, &param) != RET_OK)) {
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+
+//---------------------------------------------------------------------------------------------
+// on off command confirmed
+//
+// bufid    Buffer holding the send status of the command, freed here.
+//
+// The event stamp of the command is kept until it is delivered or given up, so a retry goes
+// out with the same sequence number.
+//
+
+static void light_switch_send_cb (zb_bufid_t bufid)
+{
+	zb_zcl_command_send_status_t *status = ZB_BUF_GET_PARAM(bufid, zb_zcl_command_send_status_t);
+
+	trace_cb_enter (TRACE_CB_SEND_ON_OFF_DONE);
+	trace_record (TRACE_TX_DONE, TRACE_TX_ON_OFF, (uint16_t)status->status);
+	diagnostics_confirm (bufid);
+	latency_cmd_sent (bufid);
+	if (delivery_confirm (bufid)) {
+		event_stamp_done (bufid);
+	}
+#ifdef APP_METRICS_CLUSTER
+	update_metrics_attrs ();
+#endif
+	zb_buf_free (bufid);
+	buf_pressure_freed ();
+	trace_cb_exit (TRACE_CB_SEND_ON_OFF_DONE);
+}
+
+
+//---------------------------------------------------------------------------------------------
+// start identifying
+//
+
+static void start_identifying (zb_bufid_t bufid)
+{
+	ZVUNUSED(bufid);
+
+	if (ZB_JOINED()) {
+		// Check if endpoint is in identifying mode,
+		// if not, put desired endpoint in identifying mode.
+		if (dev_ctx.identify_attr.identify_time ==
+		    ZB_ZCL_IDENTIFY_IDENTIFY_TIME_DEFAULT_VALUE) {
+
+			zb_ret_t zb_err_code = zb_bdb_finding_binding_target(SOURCE_ENDPOINT);
+
+			if (zb_err_code == RET_OK) {
+				LOG_INF("Enter identify mode");
+			} else if (zb_err_code == RET_INVALID_STATE) {
+				LOG_WRN("RET_INVALID_STATE - Cannot enter identify mode");
+			} else {
+				ZB_ERROR_CHECK(zb_err_code);
+			}
+		} else {
+			LOG_INF("Cancel identify mode");
+			zb_bdb_finding_binding_target_cancel();
+		}
+	} else {
+		LOG_WRN("Device not in a network - cannot enter identify mode");
+	}
+}
+
+
+//---------------------------------------------------------------------------------------------
+// identify callback
+// 
+
+static void identify_cb (zb_bufid_t bufid)
+{
+	zb_ret_t zb_err_code;
+
+	if (bufid) {
+		/* Schedule a self-scheduling function that will toggle the LED. */
+		ZB_SCHEDULE_APP_CALLBACK(toggle_identify_led, bufid);
+	} else {
+		/* Cancel the toggling function alarm and turn off LED. */
+		zb_err_code = ZB_SCHEDULE_APP_ALARM_CANCEL(toggle_identify_led, ZB_ALARM_ANY_PARAM);
+		ZVUNUSED(zb_err_code);
+
+		/* Update network status/idenitfication LED. */
+		if (ZB_JOINED()) {
+			led_set_off (ZIGBEE_NETWORK_STATE_LED);
+		} else {
+			led_set_on (ZIGBEE_NETWORK_STATE_LED);
+		}
+	}
+}
+
+
+//---------------------------------------------------------------------------------------------
+// toggle identify led
+//
+
+static void toggle_identify_led (zb_bufid_t bufid)
+{
+	static int blink_status;
+
+	trace_cb_enter (TRACE_CB_IDENTIFY_LED);
+	led_set (ZIGBEE_NETWORK_STATE_LED, (++blink_status) % 2);
+	ZB_SCHEDULE_APP_ALARM(toggle_identify_led, bufid, ZB_MILLISECONDS_TO_BEACON_INTERVAL(100));
+	trace_cb_exit (TRACE_CB_IDENTIFY_LED);
+}
+
+
+#ifdef CONFIG_APP_OTA
+//---------------------------------------------------------------------------------------------
+// ota upgrade events
+//
+// evt      Download progress, completion or failure from the fota library.
+//
+// The network state led blinks with the progress. A complete image is in the mcuboot
+// secondary slot; mcuboot swaps it in at the reboot, which needs all of RAM powered again.
+//
+
+static void ota_evt_handler (const struct zigbee_fota_evt *evt)
+{
+	const struct ota_stats *st = ota_stats ();
+
+	switch (evt->id) {
+	case ZIGBEE_FOTA_EVT_PROGRESS:
+		led_set (ZIGBEE_NETWORK_STATE_LED, evt->dl.progress % 2);
+		break;
+
+	case ZIGBEE_FOTA_EVT_FINISHED:
+		LOG_INF ("ota image of %u bytes in %u ms, %u bytes/s, rebooting",
+		         st->image_bytes, st->transfer_ms, st->bytes_per_s);
+		power_up_unused_ram ();
+		sys_reboot (SYS_REBOOT_COLD);
+		break;
+
+	case ZIGBEE_FOTA_EVT_ERROR:
+		LOG_ERR ("ota image transfer failed after %u of %u bytes", st->bytes, st->image_bytes);
+		led_set_off (ZIGBEE_NETWORK_STATE_LED);
+		break;
+
+	default:
+		break;
+	}
+
+#ifdef APP_METRICS_CLUSTER
+	update_metrics_attrs ();
+#endif
+}
+
+
+//---------------------------------------------------------------------------------------------
+// zcl device callback
+//
+// bufid    Buffer holding the zb_zcl_device_callback_param_t.
+//
+// Only the ota upgrade values are handled; every other callback is left to the stack.
+//
+
+static void zcl_device_cb (zb_bufid_t bufid)
+{
+	zb_zcl_device_callback_param_t *param = ZB_BUF_GET_PARAM(bufid, zb_zcl_device_callback_param_t);
+
+	if (param->device_cb_id == ZB_ZCL_OTA_UPGRADE_VALUE_CB_ID) {
+		ota_zcl_value (bufid);
+	} else {
+		param->status = RET_NOT_IMPLEMENTED;
+	}
+}
+#endif
+
+
+//---------------------------------------------------------------------------------------------
+// use the adc to periodically read the battery voltage on vdd pin and update the 
+// battery voltage attribute. if joined to a network, send the attribute report.
+// using the old nrfx saadc driver because it permits the adc to be shutdown between
+// samples. the zypher saadc driver does not have this capability.
+//
+
+static void read_battery_voltage_cb (struct k_timer *timer)
+{
+	// we're in an interrupt but need to complete the work outside of an interrupt
+    k_work_submit (&read_battery_voltage_work);
+}
+
+
+static void read_battery_voltage_work_handler(struct k_work *work)
+{
+	static int report_count = 0;
+
+	LOG_INF ("===== read_battery_voltage_work_handler (%d) =====", report_count++);
+	// LOG_INF ("zb_osif_is_inside_isr: %d", zb_osif_is_inside_isr());
+
+	// start the conversion and return; the workqueue is free while the saadc runs and
+	// read_battery_voltage_done finishes the job from the zboss thread
+	int err = battery_sample_start (read_battery_voltage_done);
+	if (err) {
+		LOG_WRN ("battery conversion not started: %d", err);
+		return;
+	}
+	energy_count (ENERGY_EVENT_SAADC);
+}
+
+
+static void read_battery_voltage_done (int32_t adc_mv)
+{
+	trace_cb_enter (TRACE_CB_BATTERY_DONE);
+
+	LOG_INF ("battery conversion took %u us, %u us total on the workqueue",
+	         battery_conversion_us (), battery_caller_us ());
+
+	// convert to 100s of millivolts
+	zb_uint8_t battery_voltage = (adc_mv + 50) / 100;
+
+	// convert to percentage remaining
+	zb_uint8_t battery_level = battery_level_from_mv (adc_mv);
+
+	LOG_INF ("adc: %d mV / %d / %d%%", adc_mv, battery_voltage, battery_level / 2);
+
+	// both attributes, and the alarm state when it changes, go out in one report attributes
+	// frame
+	reporting_set (ZB_ZCL_CLUSTER_ID_POWER_CONFIG,
+	               ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_ID,
+	               &battery_voltage);
+	reporting_set (ZB_ZCL_CLUSTER_ID_POWER_CONFIG,
+	               ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_REMAINING_ID,
+	               &battery_level);
+
+	// check the new sample against the thresholds and raise any alarms
+	battery_alarm_update (battery_voltage, battery_level);
+
+#ifdef APP_METRICS_CLUSTER
+	update_metrics_attrs ();
+#endif
+
+	trace_cb_exit (TRACE_CB_BATTERY_DONE);
+}
@@ -0,0 +1,112 @@
+#include <zephyr/kernel.h>
+#include <zephyr/dfu/mcuboot.h>
+
+#include <zboss_api.h>
+#include <zigbee/zigbee_fota.h>
+
+#include "ota.h"
+#include "poll_policy.h"
+
+#define FAST_POLL_INTERVAL_MS CONFIG_APP_OTA_FAST_POLL_INTERVAL_MS
+
+static zigbee_fota_callback_t evt_cb;
+static struct ota_stats stats;
+static int64_t start_ms;
+static bool fast;
+
+// fast transfer mode: every image block is a request to the server and a response the
+// parent holds until the next data poll, so the poll interval sets the transfer rate
+static void ota_fast (bool on)
+{
+	if (on == fast) {
+		return;
+	}
+
+	fast = on;
+	if (on) {
+		poll_policy_hold (FAST_POLL_INTERVAL_MS);
+	} else {
+		poll_policy_release ();
+	}
+}
+
+static void ota_evt (const struct zigbee_fota_evt *evt)
+{
+	if ((evt->id == ZIGBEE_FOTA_EVT_FINISHED) || (evt->id == ZIGBEE_FOTA_EVT_ERROR)) {
+		ota_fast (false);
+	}
+
+	evt_cb (evt);
+}
+
+int ota_init (zigbee_fota_callback_t evt)
+{
+	evt_cb = evt;
+
+	// the running image got as far as starting zigbee; without the confirmation mcuboot
+	// reverts to the previous image at the next reboot
+	if (!boot_is_img_confirmed ()) {
+		int err = boot_write_img_confirmed ();
+
+		if (err != 0) {
+			return err;
+		}
+	}
+
+	return zigbee_fota_init (ota_evt);
+}
+
+void ota_signal (zb_bufid_t bufid)
+{
+	zigbee_fota_signal_handler (bufid);
+}
+
+void ota_zcl_value (zb_bufid_t bufid)
+{
+	zb_zcl_device_callback_param_t *param = ZB_BUF_GET_PARAM(bufid, zb_zcl_device_callback_param_t);
+	zb_zcl_ota_upgrade_value_param_t *value = &param->cb_param.ota_value_param;
+	zb_uint8_t status = value->upgrade_status;
+	uint32_t length = 0;
+
+	// read before the fota library overwrites the status with its answer
+	if (status == ZB_ZCL_OTA_UPGRADE_STATUS_START) {
+		length = value->upgrade.start.file_length;
+	} else if (status == ZB_ZCL_OTA_UPGRADE_STATUS_RECEIVE) {
+		length = value->upgrade.receive.data_length;
+	}
+
+	zigbee_fota_zcl_cb (bufid);
+
+	switch (status) {
+	case ZB_ZCL_OTA_UPGRADE_STATUS_START:
+		// the library accepted the image offered
+		if (value->upgrade_status == ZB_ZCL_OTA_UPGRADE_STATUS_OK) {
+			stats = (struct ota_stats){ .image_bytes = length };
+			start_ms = k_uptime_get ();
+			ota_fast (true);
+		}
+		break;
+
+	case ZB_ZCL_OTA_UPGRADE_STATUS_RECEIVE:
+		stats.bytes += length;
+		stats.transfer_ms = (uint32_t)(k_uptime_get () - start_ms);
+		if (stats.transfer_ms > 0) {
+			stats.bytes_per_s = (uint32_t)((uint64_t)stats.bytes * MSEC_PER_SEC / stats.transfer_ms);
+		}
+		break;
+
+	// the whole image is in; checking and applying it needs no more traffic
+	case ZB_ZCL_OTA_UPGRADE_STATUS_CHECK:
+	case ZB_ZCL_OTA_UPGRADE_STATUS_ABORT:
+		ota_fast (false);
+		break;
+
+	default:
+		break;
+	}
+}
+
+const struct ota_stats *ota_stats (void)
+{
+	return &stats;
+}
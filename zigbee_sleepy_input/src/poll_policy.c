@@ -0,0 +1,138 @@
+#include <zephyr/kernel.h>
+
+#include <zboss_api.h>
+
+#include "poll_policy.h"
+#include "energy.h"
+
+#define FAST_INTERVAL_MS    CONFIG_APP_POLL_FAST_INTERVAL_MS
+#define FAST_WINDOW_MS      (CONFIG_APP_POLL_FAST_WINDOW_S * MSEC_PER_SEC)
+#define SLOW_INTERVAL_MS    CONFIG_APP_POLL_SLOW_INTERVAL_MS
+#define BACKOFF_FACTOR      CONFIG_APP_POLL_BACKOFF_FACTOR
+#define POLLS_PER_STEP      CONFIG_APP_POLL_POLLS_PER_STEP
+
+BUILD_ASSERT(FAST_INTERVAL_MS <= SLOW_INTERVAL_MS, "fast poll interval above the slow interval");
+
+static void poll_policy_step (zb_uint8_t param);
+
+static bool running;
+static uint32_t interval_ms;
+static uint32_t hold_ms;            // interval held by poll_policy_hold, 0 when not held
+
+static uint32_t polls;
+static uint32_t fast_polls;
+static int64_t mark_ms;             // uptime up to which polls have been counted
+
+// count the polls made at the current interval up to now
+static void poll_policy_fold (void)
+{
+	int64_t now = k_uptime_get ();
+
+	if (interval_ms == 0) {
+		mark_ms = now;
+		return;
+	}
+
+	uint32_t count = (uint32_t)((now - mark_ms) / interval_ms);
+
+	polls += count;
+	if (interval_ms < SLOW_INTERVAL_MS) {
+		fast_polls += count;
+	}
+	mark_ms += (int64_t)count * interval_ms;
+}
+
+static void poll_policy_set (uint32_t ms)
+{
+	if (ms == interval_ms) {
+		return;
+	}
+
+	poll_policy_fold ();
+	interval_ms = ms;
+	mark_ms = k_uptime_get ();
+
+	zb_zdo_pim_set_long_poll_interval (ms);
+	energy_set_poll_interval (ms);
+}
+
+void poll_policy_start (void)
+{
+	running = true;
+	poll_policy_kick ();
+}
+
+void poll_policy_stop (void)
+{
+	running = false;
+	ZB_SCHEDULE_APP_ALARM_CANCEL (poll_policy_step, ZB_ALARM_ANY_PARAM);
+
+	poll_policy_fold ();
+	interval_ms = 0;
+	energy_set_poll_interval (0);
+}
+
+void poll_policy_kick (void)
+{
+	if (!running) {
+		return;
+	}
+
+	if (hold_ms != 0) {
+		poll_policy_set (hold_ms);
+		return;
+	}
+
+	poll_policy_set (FAST_INTERVAL_MS);
+
+	// restart the fast window
+	ZB_SCHEDULE_APP_ALARM_CANCEL (poll_policy_step, ZB_ALARM_ANY_PARAM);
+	ZB_SCHEDULE_APP_ALARM (poll_policy_step, 0, ZB_MILLISECONDS_TO_BEACON_INTERVAL(FAST_WINDOW_MS));
+}
+
+// one step down the curve: a longer interval, kept for a few polls before the next step
+static void poll_policy_step (zb_uint8_t param)
+{
+	ZVUNUSED(param);
+
+	uint64_t next_ms = (uint64_t)interval_ms * BACKOFF_FACTOR;
+
+	if (next_ms >= SLOW_INTERVAL_MS) {
+		poll_policy_set (SLOW_INTERVAL_MS);
+		return;
+	}
+
+	poll_policy_set ((uint32_t)next_ms);
+	ZB_SCHEDULE_APP_ALARM (poll_policy_step, 0,
+	                       ZB_MILLISECONDS_TO_BEACON_INTERVAL(next_ms * POLLS_PER_STEP));
+}
+
+void poll_policy_hold (uint32_t ms)
+{
+	hold_ms = ms;
+	ZB_SCHEDULE_APP_ALARM_CANCEL (poll_policy_step, ZB_ALARM_ANY_PARAM);
+	poll_policy_kick ();
+}
+
+void poll_policy_release (void)
+{
+	hold_ms = 0;
+	poll_policy_kick ();
+}
+
+uint32_t poll_policy_interval_ms (void)
+{
+	return interval_ms;
+}
+
+uint32_t poll_policy_polls_estimate (void)
+{
+	poll_policy_fold ();
+	return polls;
+}
+
+uint32_t poll_policy_fast_polls_estimate (void)
+{
+	poll_policy_fold ();
+	return fast_polls;
+}
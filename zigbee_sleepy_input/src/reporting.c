@@ -0,0 +1,377 @@
+#include <zephyr/kernel.h>
+#include <errno.h>
+#include <string.h>
+
+#include <zboss_api.h>
+#include <zb_zcl_reporting.h>
+
+#include "reporting.h"
+#include "energy.h"
+#include "buf_pressure.h"
+#include "diagnostics.h"
+#include "trace.h"
+
+// largest reporting table the module keeps state for
+#define REPORTING_MAX_ATTRS 8
+
+// retry of a report whose buffer request zboss refused
+#define REPORTING_RETRY_MS  100
+
+// a max interval of 0xffff turns the reports of an attribute off
+#define REPORTING_MAX_OFF   0xFFFF
+
+struct reporting_state {
+	bool dirty;                 // changed by at least delta since the last report
+	bool reported;              // reported at least once
+	bool requested;             // a buffer for the frame of its cluster is on its way
+	zb_uint32_t value;          // value in the last report
+	int64_t time_ms;            // uptime of the last report, or of reporting_configure
+};
+
+static void reporting_flush (zb_uint8_t param);
+static void reporting_send (zb_bufid_t bufid, zb_uint16_t cluster_id);
+static void reporting_sent (zb_bufid_t bufid);
+
+static const struct reporting_attr *attrs;
+static size_t attr_count;
+static struct reporting_state state[REPORTING_MAX_ATTRS];
+
+static zb_uint8_t src_ep;
+static zb_uint16_t dst_addr;
+static zb_uint8_t dst_ep;
+
+// reporting_flush is queued to run after the current callback
+static bool flush_pending;
+
+// run reporting_flush after the current callback, in place of any wait for an interval
+static void reporting_flush_soon (void)
+{
+	if (!flush_pending) {
+		ZB_SCHEDULE_APP_ALARM_CANCEL (reporting_flush, ZB_ALARM_ANY_PARAM);
+		flush_pending = (ZB_SCHEDULE_APP_CALLBACK (reporting_flush, 0) == RET_OK);
+	}
+}
+
+int reporting_init (zb_uint8_t ep, const struct reporting_attr *table, size_t count)
+{
+	if (count > REPORTING_MAX_ATTRS) {
+		return -ENOMEM;
+	}
+
+	src_ep = ep;
+	attrs = table;
+	attr_count = count;
+
+	return 0;
+}
+
+// the stack's own reports of the table attributes stay off; this module sends them all
+static void reporting_stop_stack (void)
+{
+	for (size_t i = 0; i < attr_count; i++) {
+		zb_zcl_stop_attr_reporting (src_ep, attrs[i].cluster_id, ZB_ZCL_CLUSTER_SERVER_ROLE,
+		                            attrs[i].attr_id);
+	}
+}
+
+void reporting_configure (zb_uint16_t addr, zb_uint8_t ep)
+{
+	zb_zcl_reporting_info_t rep_info;
+	int64_t now = k_uptime_get ();
+
+	dst_addr = addr;
+	dst_ep = ep;
+
+	// a new destination has none of the values yet, so the next set of each one is reported.
+	// periodic reports count from now.
+	for (size_t i = 0; i < attr_count; i++) {
+		state[i].reported = false;
+		state[i].time_ms = now;
+	}
+
+	// If the maximum reporting interval is set to 0xffff then the device shall not issue any
+	// reports for the attribute. If it is set to 0x0000 and minimum reporting interval is set
+	// to something other than 0xffff then the device shall not do periodic reporting.
+	// It can still send reports on value change in the last case, but not periodic.
+
+	for (size_t i = 0; i < attr_count; i++) {
+		memset (&rep_info, 0, sizeof(rep_info));
+		rep_info.direction = ZB_ZCL_CONFIGURE_REPORTING_SEND_REPORT;
+		rep_info.ep = src_ep;
+		rep_info.cluster_id = attrs[i].cluster_id;
+		rep_info.cluster_role = ZB_ZCL_CLUSTER_SERVER_ROLE;
+		rep_info.attr_id = attrs[i].attr_id;
+		rep_info.dst.short_addr = dst_addr;
+		rep_info.dst.endpoint = dst_ep;
+		rep_info.dst.profile_id = ZB_AF_HA_PROFILE_ID;
+		rep_info.u.send_info.min_interval = attrs[i].min_interval;
+		rep_info.u.send_info.max_interval = attrs[i].max_interval;
+		rep_info.u.send_info.delta.u32 = attrs[i].delta;
+		rep_info.u.send_info.def_min_interval = attrs[i].min_interval;
+		rep_info.u.send_info.def_max_interval = attrs[i].max_interval;
+		zb_zcl_put_reporting_info (&rep_info, ZB_TRUE);
+	}
+
+	reporting_stop_stack ();
+	reporting_flush_soon ();
+}
+
+// the stack has processed a configure reporting command, which starts its own reports again
+static void reporting_reconfigured (zb_uint8_t param)
+{
+	ZVUNUSED(param);
+
+	reporting_stop_stack ();
+	reporting_flush_soon ();
+}
+
+void reporting_command (const zb_zcl_parsed_hdr_t *cmd_info)
+{
+	if (!cmd_info->is_common_command || (cmd_info->cmd_id != ZB_ZCL_CMD_CONFIG_REPORT)) {
+		return;
+	}
+
+	for (size_t i = 0; i < attr_count; i++) {
+		if (attrs[i].cluster_id == cmd_info->cluster_id) {
+			ZB_SCHEDULE_APP_CALLBACK (reporting_reconfigured, 0);
+			return;
+		}
+	}
+}
+
+static zb_zcl_attr_t *reporting_desc (size_t i)
+{
+	return zb_zcl_get_attr_desc_a (src_ep, attrs[i].cluster_id, ZB_ZCL_CLUSTER_SERVER_ROLE,
+	                               attrs[i].attr_id);
+}
+
+// attribute storage is little endian like the cpu, so a plain copy widens the value
+static zb_uint32_t reporting_value (const void *value, zb_uint8_t size)
+{
+	zb_uint32_t wide = 0;
+
+	memcpy (&wide, value, size);
+	return wide;
+}
+
+// intervals in s and delta in effect for attribute i, from the stack's reporting slot: the
+// table's unless the coordinator configured others. false when the attribute has no slot,
+// before reporting_configure or after the coordinator turned its reports off.
+static bool reporting_config (size_t i, zb_uint16_t *min_s, zb_uint16_t *max_s, zb_uint32_t *delta)
+{
+	zb_zcl_reporting_info_t *info = zb_zcl_find_reporting_info (src_ep, attrs[i].cluster_id,
+	                                                            ZB_ZCL_CLUSTER_SERVER_ROLE,
+	                                                            attrs[i].attr_id);
+	zb_zcl_attr_t *desc = reporting_desc (i);
+
+	if ((info == NULL) || (desc == NULL) ||
+	    (info->u.send_info.max_interval == REPORTING_MAX_OFF)) {
+		return false;
+	}
+
+	*min_s = info->u.send_info.min_interval;
+	*max_s = info->u.send_info.max_interval;
+
+	// the stack keeps the delta in the attribute's own type
+	*delta = reporting_value (&info->u.send_info.delta,
+	                          zb_zcl_get_attribute_size (desc->type, desc->data_p));
+	return true;
+}
+
+// ms until attribute i is due, 0 when it is due now, -1 when no report is waiting. a changed
+// value waits for the min interval after the last report, and without a change the value
+// is reported again after the max interval unless that is 0.
+static int64_t reporting_wait_ms (size_t i, int64_t now)
+{
+	zb_uint16_t min_s, max_s;
+	zb_uint32_t delta;
+	int64_t since = now - state[i].time_ms;
+	int64_t wait_ms = -1;
+
+	if (!reporting_config (i, &min_s, &max_s, &delta)) {
+		return -1;
+	}
+
+	if (state[i].dirty) {
+		wait_ms = state[i].reported ? MAX(0, (int64_t)min_s * MSEC_PER_SEC - since) : 0;
+	}
+
+	if (max_s != 0) {
+		int64_t periodic_ms = MAX(0, (int64_t)max_s * MSEC_PER_SEC - since);
+		wait_ms = (wait_ms < 0) ? periodic_ms : MIN(wait_ms, periodic_ms);
+	}
+
+	return wait_ms;
+}
+
+static bool reporting_due (size_t i, int64_t now)
+{
+	return reporting_wait_ms (i, now) == 0;
+}
+
+zb_ret_t reporting_set (zb_uint16_t cluster_id, zb_uint16_t attr_id, const void *value)
+{
+	size_t i;
+
+	for (i = 0; i < attr_count; i++) {
+		if ((attrs[i].cluster_id == cluster_id) && (attrs[i].attr_id == attr_id)) {
+			break;
+		}
+	}
+
+	zb_zcl_attr_t *desc = (i < attr_count) ? reporting_desc (i) : NULL;
+	zb_uint16_t min_s, max_s;
+	zb_uint32_t delta = 0;
+
+	if (desc == NULL) {
+		return RET_NOT_FOUND;
+	}
+
+	zb_uint8_t size = zb_zcl_get_attribute_size (desc->type, (zb_uint8_t *)value);
+	if ((size == 0) || (size > sizeof(zb_uint32_t))) {
+		return RET_INVALID_PARAMETER_1;
+	}
+
+	// write the storage directly; zb_zcl_set_attr_val would also have the stack send its own
+	// report of this attribute
+	memcpy (desc->data_p, value, size);
+
+	zb_uint32_t now_value = reporting_value (value, size);
+	zb_uint32_t change = (now_value > state[i].value) ?
+	                     (now_value - state[i].value) : (state[i].value - now_value);
+
+	// without a slot any change counts, and is reported once there is one
+	reporting_config (i, &min_s, &max_s, &delta);
+
+	if (!state[i].reported || ((change != 0) && (change >= delta))) {
+		state[i].dirty = true;
+
+		// a callback queued now runs after the caller returns, so every attribute the caller
+		// sets goes into the same frames
+		reporting_flush_soon ();
+	}
+
+	return RET_OK;
+}
+
+// request one buffer for each cluster with attributes due and wait for the rest
+static void reporting_flush (zb_uint8_t param)
+{
+	int64_t now = k_uptime_get ();
+	int64_t wait_ms = INT64_MAX;
+
+	ZVUNUSED(param);
+	trace_cb_enter (TRACE_CB_REPORTING_FLUSH);
+	flush_pending = false;
+
+	for (size_t i = 0; i < attr_count; i++) {
+		int64_t attr_wait_ms = reporting_wait_ms (i, now);
+
+		if (attr_wait_ms < 0) {
+			continue;
+		}
+
+		if (attr_wait_ms > 0) {
+			wait_ms = MIN(wait_ms, attr_wait_ms);
+			continue;
+		}
+
+		// the first due attribute of a cluster requests the frame for all of them
+		bool requested = false;
+		for (size_t j = 0; j < attr_count; j++) {
+			if ((attrs[j].cluster_id == attrs[i].cluster_id) && state[j].requested) {
+				requested = true;
+				break;
+			}
+		}
+
+		if (requested) {
+			continue;
+		}
+
+		// the attribute stays due, so the next flush asks again
+		if (buf_pressure_get (reporting_send, attrs[i].cluster_id) == RET_OK) {
+			state[i].requested = true;
+		} else {
+			wait_ms = MIN(wait_ms, REPORTING_RETRY_MS);
+		}
+	}
+
+	if (wait_ms != INT64_MAX) {
+		ZB_SCHEDULE_APP_ALARM_CANCEL (reporting_flush, ZB_ALARM_ANY_PARAM);
+		ZB_SCHEDULE_APP_ALARM (reporting_flush, 0, ZB_MILLISECONDS_TO_BEACON_INTERVAL(wait_ms));
+	}
+
+	trace_cb_exit (TRACE_CB_REPORTING_FLUSH);
+}
+
+// build and send one report attributes frame with every due attribute of the cluster
+static void reporting_send (zb_bufid_t bufid, zb_uint16_t cluster_id)
+{
+	int64_t now = k_uptime_get ();
+	size_t count = 0;
+	zb_uint8_t *ptr;
+
+	buf_pressure_granted ();
+
+	for (size_t i = 0; i < attr_count; i++) {
+		if (attrs[i].cluster_id == cluster_id) {
+			state[i].requested = false;
+		}
+	}
+
+	ptr = ZB_ZCL_START_PACKET(bufid);
+	ZB_ZCL_CONSTRUCT_GENERAL_COMMAND_REQ_FRAME_CONTROL_A(ptr, ZB_ZCL_FRAME_DIRECTION_TO_CLI,
+	                                                     ZB_ZCL_NOT_MANUFACTURER_SPECIFIC,
+	                                                     ZB_ZCL_DISABLE_DEFAULT_RESPONSE);
+	ZB_ZCL_CONSTRUCT_COMMAND_HEADER(ptr, ZB_ZCL_GET_SEQ_NUM(), ZB_ZCL_CMD_REPORT_ATTRIB);
+
+	for (size_t i = 0; i < attr_count; i++) {
+		if ((attrs[i].cluster_id != cluster_id) || !reporting_due (i, now)) {
+			continue;
+		}
+
+		zb_zcl_attr_t *desc = reporting_desc (i);
+		zb_uint8_t size = zb_zcl_get_attribute_size (desc->type, desc->data_p);
+
+		ZB_ZCL_PACKET_PUT_DATA16_VAL(ptr, attrs[i].attr_id);
+		ZB_ZCL_PACKET_PUT_DATA8(ptr, desc->type);
+		ptr = zb_zcl_put_value_to_packet (ptr, desc->type, desc->data_p);
+
+		state[i].dirty = false;
+		state[i].reported = true;
+		state[i].value = reporting_value (desc->data_p, size);
+		state[i].time_ms = now;
+		count++;
+	}
+
+	// the coordinator turned the reports off while the buffer was on its way
+	if (count == 0) {
+		zb_buf_free (bufid);
+		buf_pressure_freed ();
+		reporting_flush_soon ();
+		return;
+	}
+
+	ZB_ZCL_FINISH_PACKET(bufid, ptr)
+	trace_record (TRACE_TX, TRACE_TX_REPORT, cluster_id);
+	ZB_ZCL_SEND_COMMAND_SHORT(bufid, dst_addr, ZB_APS_ADDR_MODE_16_ENDP_PRESENT, dst_ep, src_ep,
+	                          ZB_AF_HA_PROFILE_ID, cluster_id, reporting_sent);
+	energy_count (ENERGY_EVENT_TX);
+	buf_pressure_freed ();
+
+	// wait for the next periodic report, or request the frames of other clusters now due
+	reporting_flush_soon ();
+}
+
+// aps confirm of a report, counted for the diagnostics cluster
+static void reporting_sent (zb_bufid_t bufid)
+{
+	zb_zcl_command_send_status_t *status = ZB_BUF_GET_PARAM(bufid, zb_zcl_command_send_status_t);
+
+	trace_cb_enter (TRACE_CB_REPORTING_SENT);
+	trace_record (TRACE_TX_DONE, TRACE_TX_REPORT, (uint16_t)status->status);
+	diagnostics_confirm (bufid);
+	zb_buf_free (bufid);
+	trace_cb_exit (TRACE_CB_REPORTING_SENT);
+}
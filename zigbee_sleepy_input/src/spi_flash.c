@@ -0,0 +1,115 @@
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/gpio.h>
+
+#include "spi_flash.h"
+
+#if DT_NODE_EXISTS(DT_NODELABEL(sw_spi_cs_n))
+
+#ifdef CONFIG_APP_SPI_FLASH_SPIM
+#include <soc.h>
+#include <nrfx_spim.h>
+#endif
+
+// deep power-down command, common to spi nor flash chips
+#define CMD_DEEP_POWER_DOWN     0xb9
+
+// time from the flash supply coming up to the first command it accepts
+#define POWER_UP_MS             1
+
+// half of the sck period of the bit-banged command
+#define BITBANG_HALF_PERIOD_US  1
+
+// peripheral the command is clocked out of, released again afterwards
+#define SPIM_INSTANCE           1
+
+static const struct gpio_dt_spec spi_cs_n = GPIO_DT_SPEC_GET(DT_NODELABEL(sw_spi_cs_n), gpios);
+static const struct gpio_dt_spec spi_sck = GPIO_DT_SPEC_GET(DT_NODELABEL(sw_spi_sck), gpios);
+static const struct gpio_dt_spec spi_mosi = GPIO_DT_SPEC_GET(DT_NODELABEL(sw_spi_mosi), gpios);
+static const struct gpio_dt_spec spi_wr_n = GPIO_DT_SPEC_GET(DT_NODELABEL(sw_spi_wr_n), gpios);
+static const struct gpio_dt_spec spi_hold_n = GPIO_DT_SPEC_GET(DT_NODELABEL(sw_spi_hold_n), gpios);
+
+static uint32_t last_us;
+
+// drive every pin at its idle level: deselected, clock and data low, write protect and hold
+// released. a floating chip select would leak current while asleep.
+static void spi_flash_pins_idle (void)
+{
+	gpio_pin_configure_dt (&spi_cs_n, GPIO_OUTPUT_HIGH | GPIO_ACTIVE_HIGH | GPIO_PUSH_PULL);
+	gpio_pin_configure_dt (&spi_sck, GPIO_OUTPUT_LOW | GPIO_ACTIVE_HIGH | GPIO_PUSH_PULL);
+	gpio_pin_configure_dt (&spi_mosi, GPIO_OUTPUT_LOW | GPIO_ACTIVE_HIGH | GPIO_PUSH_PULL);
+	gpio_pin_configure_dt (&spi_wr_n, GPIO_OUTPUT_HIGH | GPIO_ACTIVE_HIGH | GPIO_PUSH_PULL);
+	gpio_pin_configure_dt (&spi_hold_n, GPIO_OUTPUT_HIGH | GPIO_ACTIVE_HIGH | GPIO_PUSH_PULL);
+}
+
+// spi mode 0, msb first, timed with busy waits so the thread is never rescheduled
+static void spi_flash_bitbang (uint8_t cmd)
+{
+	gpio_pin_set_dt (&spi_cs_n, 0);
+	k_busy_wait (BITBANG_HALF_PERIOD_US);
+
+	for (int i = 0; i < 8; i++) {
+		gpio_pin_set_dt (&spi_mosi, (cmd & 0x80) ? 1 : 0);
+		cmd <<= 1;
+		k_busy_wait (BITBANG_HALF_PERIOD_US);
+		gpio_pin_set_dt (&spi_sck, 1);
+		k_busy_wait (BITBANG_HALF_PERIOD_US);
+		gpio_pin_set_dt (&spi_sck, 0);
+	}
+
+	k_busy_wait (BITBANG_HALF_PERIOD_US);
+	gpio_pin_set_dt (&spi_cs_n, 1);
+}
+
+#ifdef CONFIG_APP_SPI_FLASH_SPIM
+// blocking single byte transfer; the spim drives chip select itself
+static void spi_flash_send (uint8_t cmd)
+{
+	static const nrfx_spim_t spim = NRFX_SPIM_INSTANCE(SPIM_INSTANCE);
+	nrfx_spim_config_t config = NRFX_SPIM_DEFAULT_CONFIG(
+		NRF_DT_GPIOS_TO_PSEL(DT_NODELABEL(sw_spi_sck), gpios),
+		NRF_DT_GPIOS_TO_PSEL(DT_NODELABEL(sw_spi_mosi), gpios),
+		NRF_SPIM_PIN_NOT_CONNECTED,
+		NRF_DT_GPIOS_TO_PSEL(DT_NODELABEL(sw_spi_cs_n), gpios));
+
+	// easydma only reads from ram
+	uint8_t tx = cmd;
+	nrfx_spim_xfer_desc_t xfer = NRFX_SPIM_XFER_TX(&tx, 1);
+
+	if (nrfx_spim_init (&spim, &config, NULL, NULL) != NRFX_SUCCESS) {
+		spi_flash_bitbang (cmd);
+		return;
+	}
+
+	nrfx_spim_xfer (&spim, &xfer, 0);
+	nrfx_spim_uninit (&spim);
+}
+#else
+static void spi_flash_send (uint8_t cmd)
+{
+	spi_flash_bitbang (cmd);
+}
+#endif
+
+void spi_flash_power_down (void)
+{
+	uint32_t start = k_cycle_get_32 ();
+
+	// only a call right after boot can come before the flash is ready
+	k_sleep (K_TIMEOUT_ABS_MS(POWER_UP_MS));
+
+	spi_flash_pins_idle ();
+	spi_flash_send (CMD_DEEP_POWER_DOWN);
+
+	// releasing the spim leaves its pins disconnected
+	spi_flash_pins_idle ();
+
+	last_us = k_cyc_to_us_floor32 (k_cycle_get_32 () - start);
+}
+
+uint32_t spi_flash_power_down_us (void)
+{
+	return last_us;
+}
+
+#endif
@@ -0,0 +1,34 @@
+#include <zephyr/kernel.h>
+
+#include "stack_watermark.h"
+
+// smallest headroom any scan since boot found
+static uint32_t min_unused = UINT32_MAX;
+
+static void stack_watermark_thread (const struct k_thread *cthread, void *user_data)
+{
+	stack_watermark_cb_t cb = *(stack_watermark_cb_t *)user_data;
+	struct k_thread *thread = (struct k_thread *)cthread;
+	const char *name = k_thread_name_get (thread);
+	size_t unused;
+
+	if (k_thread_stack_space_get (thread, &unused) != 0) {
+		return;
+	}
+
+	min_unused = MIN(min_unused, (uint32_t)unused);
+
+	if (cb != NULL) {
+		cb ((name != NULL) ? name : "?", thread->stack_info.size, unused);
+	}
+}
+
+void stack_watermark_scan (stack_watermark_cb_t cb)
+{
+	k_thread_foreach (stack_watermark_thread, &cb);
+}
+
+uint32_t stack_watermark_min_unused (void)
+{
+	return (min_unused == UINT32_MAX) ? 0 : min_unused;
+}
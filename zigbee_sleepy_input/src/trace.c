@@ -0,0 +1,95 @@
+#include <zephyr/kernel.h>
+
+#ifdef CONFIG_USE_SEGGER_RTT
+#include <SEGGER_RTT.h>
+#endif
+
+#include "trace.h"
+
+#define TRACE_RECORDS       CONFIG_APP_TRACE_RECORDS
+#define TRACE_MASK          (TRACE_RECORDS - 1)
+
+BUILD_ASSERT((TRACE_RECORDS & TRACE_MASK) == 0, "trace records must be a power of two");
+BUILD_ASSERT(sizeof(struct trace_record) == 8, "trace records are 8 bytes on the wire");
+
+// the ring and its indices; head and tail count records since boot. a debugger can read the
+// ring from ram after a crash.
+struct trace_record trace_ring[TRACE_RECORDS];
+static uint32_t head;
+static uint32_t tail;
+static struct k_spinlock lock;
+
+#ifdef CONFIG_USE_SEGGER_RTT
+static uint8_t rtt_buf[CONFIG_APP_TRACE_RTT_BUFFER_SIZE];
+#endif
+
+void trace_init (void)
+{
+#ifdef CONFIG_USE_SEGGER_RTT
+	SEGGER_RTT_ConfigUpBuffer (CONFIG_APP_TRACE_RTT_CHANNEL, "trace", rtt_buf, sizeof(rtt_buf),
+	                           SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+#endif
+}
+
+void trace_record (enum trace_type type, uint8_t id, uint16_t arg)
+{
+	k_spinlock_key_t key = k_spin_lock (&lock);
+	struct trace_record *rec = &trace_ring[head++ & TRACE_MASK];
+
+	rec->cycles = k_cycle_get_32 ();
+	rec->type = type;
+	rec->id = id;
+	rec->arg = arg;
+
+	k_spin_unlock (&lock, key);
+}
+
+#ifdef CONFIG_USE_SEGGER_RTT
+// write count records to the channel, which has room for them
+static void trace_write (const struct trace_record *rec, uint32_t count)
+{
+	SEGGER_RTT_WriteSkipNoLock (CONFIG_APP_TRACE_RTT_CHANNEL, rec, count * sizeof(struct trace_record));
+}
+#endif
+
+void trace_flush (void)
+{
+#ifdef CONFIG_USE_SEGGER_RTT
+	k_spinlock_key_t key = k_spin_lock (&lock);
+	uint32_t room = SEGGER_RTT_GetAvailWriteSpace (CONFIG_APP_TRACE_RTT_CHANNEL) /
+	                sizeof(struct trace_record);
+
+	// the host may attach at any time, so every flush starts with the clock rate, then tells
+	// how many records were overwritten before they could be flushed
+	if ((head == tail) || (room < 3)) {
+		k_spin_unlock (&lock, key);
+		return;
+	}
+
+	struct trace_record clock = { sys_clock_hw_cycles_per_sec (), TRACE_CLOCK, 0, 0 };
+
+	trace_write (&clock, 1);
+	room--;
+
+	if ((head - tail) > TRACE_RECORDS) {
+		struct trace_record lost = { k_cycle_get_32 (), TRACE_LOST, 0,
+		                             (uint16_t)MIN(head - tail - TRACE_RECORDS, UINT16_MAX) };
+
+		trace_write (&lost, 1);
+		room--;
+		tail = head - TRACE_RECORDS;
+	}
+
+	// the end of the ring and then its start, as far as the channel has room
+	while ((tail != head) && (room > 0)) {
+		uint32_t start = tail & TRACE_MASK;
+		uint32_t count = MIN(MIN(head - tail, TRACE_RECORDS - start), room);
+
+		trace_write (&trace_ring[start], count);
+		tail += count;
+		room -= count;
+	}
+
+	k_spin_unlock (&lock, key);
+#endif
+}
@@ -0,0 +1,159 @@
+//---------------------------------------------------------------------------------------------
+// battery tests
+//
+// The build time lookup table of the selected chemistry against the runtime interpolation it
+// replaced, for every mV a 16 bit reading can hold, and both timed on the host. The
+// conversion goes through the fake zboss stack's saadc, which returns its virtual battery
+// voltage on the input battery.c selects.
+//
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <native_rtc.h>
+
+#include <zboss_api.h>
+#include <zb_nrf_platform.h>
+
+#include "battery.h"
+
+// lookups timed per benchmark run
+#define BENCH_LOOKUPS       1000000
+
+// coin cell voltage-capacity pairs
+typedef struct {
+  uint16_t      voltage;
+  uint8_t       capacity;
+} voltage_capacity_pair_t;
+
+// the points of the curve in battery_curves.h, highest voltage first
+#if defined(CONFIG_APP_BATTERY_AAA_LITHIUM)
+static voltage_capacity_pair_t vcPairs[] =
+{ { 3400, 200 }, { 3100, 180 }, { 3000, 140 }, { 2900, 100 }, { 2800, 60 },
+  { 2600, 20 }, { 2000, 0 } };
+#elif defined(CONFIG_APP_BATTERY_LIPO)
+static voltage_capacity_pair_t vcPairs[] =
+{ { 4200, 200 }, { 4100, 180 }, { 4000, 160 }, { 3900, 130 }, { 3800, 100 },
+  { 3700, 60 }, { 3600, 20 }, { 3500, 10 }, { 3000, 0 } };
+#else
+// Voltage - Capacity pair table from thunderboard react
+// Algorithm assumes the values are arranged in a descending order.
+// The values in the table are an average of those found in the CR2032 datasheets from
+// Energizer, Maxell and Panasonic. Table modified for zigbee half percent steps.
+static voltage_capacity_pair_t vcPairs[] =
+{ { 3000, 200 }, { 2900, 160 }, { 2800, 120 }, { 2700, 80 }, { 2600, 60 },
+  { 2500, 40 }, { 2400, 20 }, { 2000, 0 } };
+#endif
+
+// the interpolation the lookup table replaced, as it was in the applications' main.c
+// from thunderboard react
+static uint8_t cr2032_CalculateLevel (uint16_t voltage)
+{
+  uint32_t res = 0;
+  uint8_t i;
+
+  // Iterate through voltage/capacity table until correct interval is found.
+  // Then interpolate capacity within that interval based on a linear approximation
+  // between the capacity at the low and high end of the interval.
+  for (i = 0; i < (sizeof(vcPairs) / sizeof(voltage_capacity_pair_t)); i++) {
+    if (voltage > vcPairs[i].voltage) {
+      if (i == 0) {
+        // Higher than maximum voltage in table.
+        return vcPairs[0].capacity;
+      } else {
+        // Calculate the capacity by interpolation.
+        res = (voltage - vcPairs[i].voltage)
+              * (vcPairs[i - 1].capacity - vcPairs[i].capacity)
+              / (vcPairs[i - 1].voltage - vcPairs[i].voltage);
+        res += vcPairs[i].capacity;
+        return (uint8_t)res;
+      }
+    }
+  }
+  // Below the minimum voltage in the table.
+  return vcPairs[sizeof(vcPairs) / sizeof(voltage_capacity_pair_t) - 1].capacity;
+}
+
+static K_SEM_DEFINE (sample_done, 0, 1);
+static int32_t sample_mv;
+
+static void record_sample (int32_t mv)
+{
+	sample_mv = mv;
+	k_sem_give (&sample_done);
+}
+
+// the fake stack hands its startup signals to the application
+void zboss_signal_handler (zb_bufid_t bufid)
+{
+	zb_buf_free (bufid);
+}
+
+// sink for the benchmarked lookups, so the compiler keeps them
+static volatile uint32_t bench_sink;
+
+// host time in us for BENCH_LOOKUPS lookups of level () over a sweep of the curve and past
+// both ends
+static uint64_t bench_us (uint8_t (*level)(uint16_t mv))
+{
+	uint32_t sum = 0;
+	uint64_t start_us = native_rtc_gettime_us (RTC_CLOCK_REALTIME);
+
+	for (uint32_t i = 0; i < BENCH_LOOKUPS; i++) {
+		sum += level (1500 + (i % 3500));
+	}
+
+	uint64_t elapsed_us = native_rtc_gettime_us (RTC_CLOCK_REALTIME) - start_us;
+
+	bench_sink = sum;
+	return elapsed_us;
+}
+
+static uint8_t lut_level (uint16_t mv)
+{
+	return battery_level_from_mv (mv);
+}
+
+static void *battery_setup (void)
+{
+	battery_init ();
+	zigbee_enable ();
+	return NULL;
+}
+
+ZTEST(battery, test_lut_matches_interpolation)
+{
+	for (uint32_t mv = 0; mv <= UINT16_MAX; mv++) {
+		zassert_equal (battery_level_from_mv (mv), cr2032_CalculateLevel (mv),
+		               "%u mV: lookup %u, interpolation %u", mv, battery_level_from_mv (mv),
+		               cr2032_CalculateLevel (mv));
+	}
+}
+
+ZTEST(battery, test_lut_below_zero)
+{
+	zassert_equal (battery_level_from_mv (-1), cr2032_CalculateLevel (0));
+	zassert_equal (battery_level_from_mv (INT32_MIN), cr2032_CalculateLevel (0));
+}
+
+ZTEST(battery, test_sample_reads_battery)
+{
+	zassert_ok (battery_sample_start (record_sample));
+	zassert_ok (k_sem_take (&sample_done, K_SECONDS(1)), "conversion never finished");
+
+	// one step of the 14 bit result is 0.22 mV on vdd and 1.1 mV on vddh / 5, and the
+	// conversions round down on both sides
+	zassert_within (sample_mv, CONFIG_ZBOSS_FAKE_BATTERY_MV, 2, "read %d mV of %d mV",
+	                sample_mv, CONFIG_ZBOSS_FAKE_BATTERY_MV);
+}
+
+ZTEST(battery, test_benchmark)
+{
+	uint64_t interpolation_us = bench_us (cr2032_CalculateLevel);
+	uint64_t lut_us = bench_us (lut_level);
+
+	TC_PRINT ("%d lookups: interpolation %llu us, lookup table %llu us\n", BENCH_LOOKUPS,
+	          (unsigned long long)interpolation_us, (unsigned long long)lut_us);
+}
+
+ZTEST_SUITE(battery, NULL, battery_setup, NULL, NULL, NULL);
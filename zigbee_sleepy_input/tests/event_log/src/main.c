@@ -0,0 +1,230 @@
+//---------------------------------------------------------------------------------------------
+// event log tests
+//
+// Events pushed past the ram queue spill to the flash log in the storage partition of the
+// native_sim flash simulator. The fake zboss stack runs the replay alarms in virtual time, and
+// calling event_log_init () again stands in for a reboot: the ram queue is lost and the log is
+// read back from flash.
+//
+
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/ztest.h>
+#include <errno.h>
+
+#include <zboss_api.h>
+#include <zb_nrf_platform.h>
+
+#include "event_log.h"
+
+#define QUEUE_SIZE          CONFIG_APP_EVENT_QUEUE_SIZE
+#define REPLAY_INTERVAL_MS  CONFIG_APP_EVENT_REPLAY_INTERVAL_MS
+
+// layout of the log in event_log.c
+#define LOG_PAGE_SIZE       4096
+#define LOG_RECORD_SIZE     16
+
+#define SENT_MAX            2048
+
+static const struct flash_area *fa;
+
+// events the replay handed over, in order
+static uint16_t sent_cmds[SENT_MAX];
+static int64_t sent_ages[SENT_MAX];
+static size_t sent_count;
+
+// replay sends to fail before the next one goes through
+static int send_failures;
+
+static int record_send (const struct event_log_entry *entry)
+{
+	if (send_failures > 0) {
+		send_failures--;
+		return -EAGAIN;
+	}
+
+	if (sent_count < SENT_MAX) {
+		sent_cmds[sent_count] = entry->cmd_id;
+		sent_ages[sent_count] = event_log_age_ms (entry);
+	}
+	sent_count++;
+	return 0;
+}
+
+// the fake stack hands its startup signals to the application
+void zboss_signal_handler (zb_bufid_t bufid)
+{
+	zb_buf_free (bufid);
+}
+
+// events with command ids first, first + 1, ... whose edges are now
+static void push_events (uint16_t first, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		event_log_push (0, first + i, k_uptime_get_32 ());
+	}
+}
+
+// replay until nothing is held back, in virtual time
+static void replay_all (void)
+{
+	event_log_replay_start ();
+
+	for (int i = 0; (i < 10000) && event_log_pending (); i++) {
+		k_sleep (K_MSEC(REPLAY_INTERVAL_MS));
+	}
+
+	// the batch that emptied the log may still be writing its replay mark
+	k_sleep (K_MSEC(REPLAY_INTERVAL_MS));
+	event_log_replay_stop ();
+
+	zassert_false (event_log_pending (), "replay did not finish");
+}
+
+// the replayed command ids are first, first + 1, ... first + n - 1
+static void assert_sent (size_t at, uint16_t first, size_t n)
+{
+	zassert_true (at + n <= sent_count, "%zu events replayed, expected at least %zu",
+	              sent_count, at + n);
+
+	for (size_t i = 0; i < n; i++) {
+		zassert_equal (sent_cmds[at + i], first + i, "event %zu replayed as command %u, expected %zu",
+		               at + i, sent_cmds[at + i], first + i);
+	}
+}
+
+static void *event_log_setup (void)
+{
+	zassert_ok (flash_area_open (FIXED_PARTITION_ID(storage_partition), &fa));
+	zassert_true (fa->fa_size >= 2 * LOG_PAGE_SIZE, "storage partition too small for the log");
+
+	zigbee_enable ();
+	return NULL;
+}
+
+static void event_log_before (void *fixture)
+{
+	ZVUNUSED(fixture);
+
+	zassert_ok (flash_area_erase (fa, 0, fa->fa_size));
+
+	sent_count = 0;
+	send_failures = 0;
+	zassert_ok (event_log_init (record_send));
+}
+
+ZTEST(event_log, test_queue_replays_in_order)
+{
+	push_events (0, QUEUE_SIZE);
+	replay_all ();
+
+	zassert_equal (sent_count, QUEUE_SIZE);
+	assert_sent (0, 0, QUEUE_SIZE);
+
+	for (size_t i = 0; i < sent_count; i++) {
+		zassert_true (sent_ages[i] >= 0, "age of an event from this boot is unknown");
+	}
+}
+
+ZTEST(event_log, test_spill_keeps_order)
+{
+	const size_t n = 5 * QUEUE_SIZE + 2;
+
+	push_events (0, n);
+	replay_all ();
+
+	zassert_equal (sent_count, n);
+	assert_sent (0, 0, n);
+	zassert_equal (event_log_dropped (), 0);
+}
+
+ZTEST(event_log, test_reboot_replays_spilled_events)
+{
+	uint16_t boot = event_log_boot ();
+
+	// two spills of a full queue, and one event left in ram that the reboot loses
+	push_events (0, 2 * QUEUE_SIZE + 1);
+
+	zassert_ok (event_log_init (record_send));
+	zassert_equal (event_log_boot (), boot + 1);
+	zassert_true (event_log_pending ());
+
+	replay_all ();
+
+	zassert_equal (sent_count, 2 * QUEUE_SIZE);
+	assert_sent (0, 0, 2 * QUEUE_SIZE);
+
+	for (size_t i = 0; i < sent_count; i++) {
+		zassert_equal (sent_ages[i], -1, "age of an event from before the reboot is known");
+	}
+}
+
+ZTEST(event_log, test_replayed_events_stay_replayed)
+{
+	push_events (0, QUEUE_SIZE + 1);
+	replay_all ();
+	zassert_equal (sent_count, QUEUE_SIZE + 1);
+
+	zassert_ok (event_log_init (record_send));
+	zassert_false (event_log_pending (), "replayed events are held back again after a reboot");
+}
+
+ZTEST(event_log, test_boot_number_advances)
+{
+	uint16_t boot = event_log_boot ();
+
+	for (int i = 1; i <= 3; i++) {
+		zassert_ok (event_log_init (record_send));
+		zassert_equal (event_log_boot (), boot + i);
+	}
+}
+
+ZTEST(event_log, test_torn_record_skipped)
+{
+	// the boot record in slot 0, then the spilled queue
+	push_events (0, QUEUE_SIZE + 1);
+
+	// a reset in the middle of writing the next slot: a sequence number and nothing else
+	const uint32_t torn[2] = { 0x10000, 0 };
+	const off_t torn_offset = (QUEUE_SIZE + 1) * LOG_RECORD_SIZE;
+
+	zassert_ok (flash_area_write (fa, torn_offset, torn, sizeof(torn)));
+
+	zassert_ok (event_log_init (record_send));
+	push_events (100, QUEUE_SIZE + 1);
+	zassert_ok (event_log_init (record_send));
+
+	replay_all ();
+
+	zassert_equal (sent_count, 2 * QUEUE_SIZE);
+	assert_sent (0, 0, QUEUE_SIZE);
+	assert_sent (QUEUE_SIZE, 100, QUEUE_SIZE);
+}
+
+ZTEST(event_log, test_wrap_drops_oldest_page)
+{
+	const size_t slots = (fa->fa_size / LOG_PAGE_SIZE) * (LOG_PAGE_SIZE / LOG_RECORD_SIZE);
+	const size_t n = slots + slots / 2;
+
+	zassert_true (n < SENT_MAX);
+
+	push_events (0, n);
+	replay_all ();
+
+	// whole pages of the oldest events go, the rest arrive in order and end with the newest
+	zassert_true (event_log_dropped () > 0, "log never wrapped");
+	zassert_equal (sent_count + event_log_dropped (), n);
+	assert_sent (0, event_log_dropped (), sent_count);
+}
+
+ZTEST(event_log, test_failed_send_retried)
+{
+	push_events (0, 3);
+	send_failures = 2;
+	replay_all ();
+
+	zassert_equal (sent_count, 3);
+	assert_sent (0, 0, 3);
+}
+
+ZTEST_SUITE(event_log, NULL, event_log_setup, event_log_before, NULL, NULL);